@@ -0,0 +1,182 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import avm2.intrinsics.memory.lf32;
+	import avm2.intrinsics.memory.lf64;
+	import avm2.intrinsics.memory.li32;
+	import avm2.intrinsics.memory.li8;
+	import avm2.intrinsics.memory.sxi8;
+	import com.hurlant.math.BigInteger;
+	import flash.system.ApplicationDomain;
+	import flash.utils.ByteArray;
+	import flash.utils.IDataInput;
+
+	/**
+	 * A CodedInputStream over a ByteArray selected as domain memory, which
+	 * decodes varints and fixed size values with the memory intrinsics
+	 * instead of one readByte() call per byte. The ByteArray position is
+	 * kept in sync, so the rest of CodedInputStream works unchanged.
+	 *
+	 * Domain memory is shared by the whole ApplicationDomain: no other
+	 * code may select its own until release() is called.
+	 */
+	public class DomainMemoryInputStream extends CodedInputStream {
+
+	  // Longest varint, reads closer to the end or to the current limit are
+	  // checked byte per byte
+	  private static const MAX_VARINT_SIZE:int = 10;
+
+	  private var bytes:ByteArray;
+	  private var previousMemory:ByteArray;
+
+	  /**
+	   * Returns a DomainMemoryInputStream when input is a ByteArray large
+	   * enough to be selected as domain memory, a CodedInputStream
+	   * otherwise.
+	   */
+	  public static function newInstance(input:IDataInput):CodedInputStream {
+	  	var bytes:ByteArray = input as ByteArray;
+	  	if (bytes == null || bytes.length < ApplicationDomain.MIN_DOMAIN_MEMORY_LENGTH)
+	  		return CodedInputStream.newInstance(input);
+	  	return new DomainMemoryInputStream(bytes);
+	  }
+
+	  public function DomainMemoryInputStream(bytes:ByteArray) {
+	  	super(bytes);
+	  	this.bytes = bytes;
+	  	var domain:ApplicationDomain = ApplicationDomain.currentDomain;
+	  	previousMemory = domain.domainMemory;
+	  	domain.domainMemory = bytes;
+	  }
+
+	  /** Selects the domain memory in use before this stream again. */
+	  public function release():void {
+	  	ApplicationDomain.currentDomain.domainMemory = previousMemory;
+	  }
+
+	  override public function readRawByte():int {
+	  	var pos:int = bytes.position;
+	  	if (pos >= bytes.length || totalBytesRead >= currentLimit)
+	  		throw InvalidProtocolBufferException.truncatedMessage();
+	  	advance(pos + 1);
+	  	return sxi8(li8(pos));
+	  }
+
+	  override public function readRawVarint32():int {
+	  	var pos:int = bytes.position;
+	  	if (!canRead(pos, MAX_VARINT_SIZE))
+	  		return super.readRawVarint32();
+
+	  	var result:int = 0;
+	  	for (var shift:int = 0; shift < 32; shift += 7) {
+	  		var b:int = li8(pos++);
+	  		result |= (b & 0x7F) << shift;
+	  		if (b < 0x80) {
+	  			advance(pos);
+	  			return result;
+	  		}
+	  	}
+	  	// Discard upper 32 bits.
+	  	for (var i:int = 0; i < 5; i++) {
+	  		if (li8(pos++) < 0x80) {
+	  			advance(pos);
+	  			return result;
+	  		}
+	  	}
+	  	throw InvalidProtocolBufferException.malformedVarint();
+	  }
+
+	  override public function readRawVarint64():BigInteger {
+	  	var pos:int = bytes.position;
+	  	if (!canRead(pos, MAX_VARINT_SIZE))
+	  		return super.readRawVarint64();
+
+	  	var low:int = 0;
+	  	var high:int = 0;
+	  	for (var shift:int = 0; shift < 64; shift += 7) {
+	  		var b:int = li8(pos++);
+	  		var bits:int = b & 0x7F;
+	  		if (shift < 32) {
+	  			low |= bits << shift;
+	  			if (shift > 25)
+	  				high |= bits >>> (32 - shift);
+	  		} else {
+	  			high |= bits << (shift - 32);
+	  		}
+	  		if (b < 0x80) {
+	  			advance(pos);
+	  			return toBigInteger(high, low);
+	  		}
+	  	}
+	  	throw InvalidProtocolBufferException.malformedVarint();
+	  }
+
+	  override public function readRawLittleEndian32():int {
+	  	var pos:int = consume(4);
+	  	return li32(pos);
+	  }
+
+	  override public function readRawLittleEndian64():BigInteger {
+	  	var pos:int = consume(8);
+	  	return toBigInteger(li32(pos + 4), li32(pos));
+	  }
+
+	  override public function readFloat():Number {
+	  	var pos:int = consume(4);
+	  	return lf32(pos);
+	  }
+
+	  override public function readDouble():Number {
+	  	var pos:int = consume(8);
+	  	return lf64(pos);
+	  }
+
+	  // -----------------------------------------------------------------
+
+	  /** Consumes size bytes, returning where they start. */
+	  private function consume(size:int):int {
+	  	var pos:int = bytes.position;
+	  	if (!canRead(pos, size))
+	  		throw InvalidProtocolBufferException.truncatedMessage();
+	  	advance(pos + size);
+	  	return pos;
+	  }
+
+	  /**
+	   * Whether size bytes from pos are both in the ByteArray and before
+	   * the current limit, see pushLimit().
+	   */
+	  private function canRead(pos:int, size:int):Boolean {
+	  	return pos + size <= bytes.length && size <= currentLimit - totalBytesRead;
+	  }
+
+	  private function advance(pos:int):void {
+	  	totalBytesRead += pos - bytes.position;
+	  	bytes.position = pos;
+	  }
+
+	  /** Same unsigned BigInteger as CodedInputStream builds. */
+	  private static function toBigInteger(high:int, low:int):BigInteger {
+	  	var ba:ByteArray = new ByteArray();
+	  	ba.writeInt(high);
+	  	ba.writeInt(low);
+	  	ba.position = 0;
+	  	return new BigInteger(ba);
+	  }
+	}
+}
@@ -0,0 +1,118 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import avm2.intrinsics.memory.sf32;
+	import avm2.intrinsics.memory.sf64;
+	import avm2.intrinsics.memory.si32;
+	import avm2.intrinsics.memory.si8;
+	import flash.system.ApplicationDomain;
+	import flash.utils.ByteArray;
+	import flash.utils.IDataOutput;
+
+	/**
+	 * A CodedOutputStream which encodes into a buffer selected as domain
+	 * memory with the memory intrinsics, and hands the buffer to the
+	 * output in blocks. flush() must be called once done, as
+	 * Message.writeToDataOutput() does.
+	 *
+	 * Domain memory is shared by the whole ApplicationDomain: no other
+	 * code may select its own until release() is called.
+	 */
+	public class DomainMemoryOutputStream extends CodedOutputStream {
+
+	  private var output:IDataOutput;
+	  private var buffer:ByteArray;
+	  private var bufferSize:int;
+	  private var pos:int = 0;
+	  private var previousMemory:ByteArray;
+
+	  public function DomainMemoryOutputStream(output:IDataOutput,
+	                                           bufferSize:int = CodedOutputStream.DEFAULT_BUFFER_SIZE) {
+	  	super(output);
+	  	this.output = output;
+	  	this.bufferSize = Math.max(bufferSize, ApplicationDomain.MIN_DOMAIN_MEMORY_LENGTH);
+	  	buffer = new ByteArray();
+	  	buffer.length = this.bufferSize;
+	  	var domain:ApplicationDomain = ApplicationDomain.currentDomain;
+	  	previousMemory = domain.domainMemory;
+	  	domain.domainMemory = buffer;
+	  }
+
+	  /** Selects the domain memory in use before this stream again. */
+	  public function release():void {
+	  	flush();
+	  	ApplicationDomain.currentDomain.domainMemory = previousMemory;
+	  }
+
+	  override public function flush():void {
+	  	if (pos > 0) {
+	  		output.writeBytes(buffer, 0, pos);
+	  		pos = 0;
+	  	}
+	  }
+
+	  override public function writeRawByte(value:int):void {
+	  	if (pos == bufferSize)
+	  		flush();
+	  	si8(value, pos++);
+	  }
+
+	  /** Small values are copied in, large ones go straight to the output. */
+	  override public function writeRawBytesPartial(value:ByteArray, offset:int, length:int):void {
+	  	if (length <= bufferSize - pos) {
+	  		buffer.position = pos;
+	  		buffer.writeBytes(value, offset, length);
+	  		pos += length;
+	  	} else {
+	  		flush();
+	  		output.writeBytes(value, offset, length);
+	  	}
+	  }
+
+	  override public function writeRawVarint32(value:int):void {
+	  	if (pos + 5 > bufferSize)
+	  		flush();
+	  	while ((value & ~0x7F) != 0) {
+	  		si8((value & 0x7F) | 0x80, pos++);
+	  		value >>>= 7;
+	  	}
+	  	si8(value, pos++);
+	  }
+
+	  override public function writeRawLittleEndian32(value:int):void {
+	  	if (pos + 4 > bufferSize)
+	  		flush();
+	  	si32(value, pos);
+	  	pos += 4;
+	  }
+
+	  override public function writeRawFloat(value:Number):void {
+	  	if (pos + 4 > bufferSize)
+	  		flush();
+	  	sf32(value, pos);
+	  	pos += 4;
+	  }
+
+	  override public function writeRawDouble(value:Number):void {
+	  	if (pos + 8 > bufferSize)
+	  		flush();
+	  	sf64(value, pos);
+	  	pos += 8;
+	  }
+	}
+}
@@ -0,0 +1,48 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.utils.ByteArray;
+
+	/**
+	 * A response kept by a CachingRpcChannel, encoded so every caller gets
+	 * its own copy.
+	 */
+	internal final class CachedResponse {
+
+	  public var key:String;
+	  public var bytes:ByteArray;
+	  public var responseType:Class;
+	  public var expires:int;
+	  public var removed:Boolean = false;
+
+	  public function CachedResponse(key:String, response:Message, responseType:Class, expires:int) {
+	  	this.key = key;
+	  	this.bytes = response.toByteArray();
+	  	this.responseType = responseType;
+	  	this.expires = expires;
+	  }
+
+	  /** A new copy of the response. */
+	  public function get response():Message {
+	  	var copy:Message = new responseType();
+	  	bytes.position = 0;
+	  	copy.readFromDataOutput(bytes);
+	  	return copy;
+	  }
+	}
+}
@@ -0,0 +1,133 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import com.hurlant.util.Base64;
+	import flash.utils.ByteArray;
+	import flash.utils.getTimer;
+
+	/**
+	 * An RpcChannel in front of another one, answering repeated calls of
+	 * idempotent methods from a cache. Only the methods given to
+	 * cacheMethod() are cached, the others go straight through.
+	 *
+	 * Calls are keyed by method and request bytes. Identical calls made
+	 * while the first is still in flight share its response. Responses are
+	 * kept for the time to live of their method, up to maxEntries of them,
+	 * the oldest going first. Errors are never cached.
+	 *
+	 * Every caller gets its own response: the cache keeps them encoded and
+	 * decodes a copy for each hit. Extensions missing from
+	 * ExtensionRegistry.generated are dropped from the copies.
+	 */
+	public class CachingRpcChannel implements RpcChannel {
+
+	  public static const DEFAULT_MAX_ENTRIES:int = 256;
+
+	  private var channel:RpcChannel;
+	  private var maxEntries:int;
+
+	  // Time to live by method name, in milliseconds
+	  private var ttls:Object = new Object();
+
+	  // CachedResponse by key, and in insertion order
+	  private var entries:Object = new Object();
+	  private var order:Array = new Array();
+	  private var entryCount:int = 0;
+
+	  // Callbacks of the calls in flight, by key
+	  private var waiting:Object = new Object();
+
+	  public function CachingRpcChannel(channel:RpcChannel, maxEntries:int = DEFAULT_MAX_ENTRIES) {
+	  	this.channel = channel;
+	  	this.maxEntries = maxEntries;
+	  }
+
+	  /** Caches the responses of the method for ttlMs milliseconds. */
+	  public function cacheMethod(method:String, ttlMs:int):void {
+	  	ttls[method] = ttlMs;
+	  }
+
+	  public function callMethod(method:String, request:Message, responseType:Class, done:Function):void {
+	  	if (!ttls.hasOwnProperty(method)) {
+	  		channel.callMethod(method, request, responseType, done);
+	  		return;
+	  	}
+
+	  	var bytes:ByteArray = request.toByteArray();
+	  	var key:String = method + " " + Base64.encodeByteArray(bytes);
+
+	  	var entry:CachedResponse = entries[key];
+	  	if (entry != null) {
+	  		if (getTimer() < entry.expires) {
+	  			done(entry.response, null);
+	  			return;
+	  		}
+	  		remove(entry);
+	  	}
+
+	  	var callbacks:Array = waiting[key];
+	  	if (callbacks != null) {
+	  		callbacks.push(done);
+	  		return;
+	  	}
+	  	waiting[key] = [done];
+	  	channel.callMethod(method, request, responseType,
+	  		function(response:Message, error:Error):void {
+	  			var cached:CachedResponse = null;
+	  			if (error == null) {
+	  				cached = new CachedResponse(key, response, responseType, getTimer() + ttls[method]);
+	  				add(cached);
+	  			}
+	  			var calls:Array = waiting[key];
+	  			delete waiting[key];
+	  			//the first caller gets the response itself, the others copies
+	  			for (var i:int = 0; i < calls.length; i++)
+	  				calls[i](i == 0 || cached == null ? response : cached.response, error);
+	  		});
+	  }
+
+	  /** Forgets all the cached responses. */
+	  public function clear():void {
+	  	entries = new Object();
+	  	order.length = 0;
+	  	entryCount = 0;
+	  }
+
+	  private function add(entry:CachedResponse):void {
+	  	var old:CachedResponse = entries[entry.key];
+	  	if (old != null)
+	  		remove(old);
+	  	entries[entry.key] = entry;
+	  	order.push(entry);
+	  	entryCount++;
+	  	while (entryCount > maxEntries)
+	  		remove(order[0]);
+	  }
+
+	  /** Removes the entry, from order as well once it reaches the front. */
+	  private function remove(entry:CachedResponse):void {
+	  	if (entries[entry.key] == entry) {
+	  		delete entries[entry.key];
+	  		entryCount--;
+	  	}
+	  	entry.removed = true;
+	  	while (order.length > 0 && CachedResponse(order[0]).removed)
+	  		order.shift();
+	  }
+	}
+}
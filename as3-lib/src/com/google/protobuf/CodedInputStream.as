@@ -44,7 +44,7 @@ package com.google.protobuf
 	   */
 	  public function readTag():int {
 	  	
-	  	if ( input.bytesAvailable != 0)
+	  	if (totalBytesRead != currentLimit && input.bytesAvailable != 0)
 		    lastTag = readRawVarint32();
 		else 
 			lastTag = 0;
@@ -113,7 +113,7 @@ package com.google.protobuf
 	  // -----------------------------------------------------------------
 	
 	  /** Read a {@code double} field value from the stream. */
-	  public function readDouble():BigInteger {
+	  public function readDouble():Number {
 	    //return readRawLittleEndian64();
 	  	
 	    var b1:int = readRawByte();
@@ -220,6 +220,38 @@ package com.google.protobuf
 	    builder.mergeFrom(this, extensionRegistry);
 	    checkLastTagWas(0);
 	  }*/
+
+	  /**
+	   * Read an embedded message field value from the stream, merging it
+	   * into {@code value}. The message is read in place, under a limit,
+	   * instead of being copied out first.
+	   *
+	   * @return {@code value}
+	   */
+	  public function readMessage(value:Message, mask:FieldMask = null):Message {
+	    var length:int = readRawVarint32();
+	    var oldLimit:int = pushLimit(length);
+	    value.readFromCodedStream(this, mask);
+	    checkLastTagWas(0);
+	    if (totalBytesRead != currentLimit) {
+	      throw InvalidProtocolBufferException.truncatedMessage();
+	    }
+	    popLimit(oldLimit);
+	    return value;
+	  }
+
+	  /**
+	   * Read a {@code group} field value from the stream, merging it
+	   * into {@code value}.
+	   *
+	   * @return {@code value}
+	   */
+	  public function readGroup(fieldNumber:int, value:Message, mask:FieldMask = null):Message {
+	    value.readFromCodedStream(this, mask);
+	    checkLastTagWas(
+	      WireFormat.makeTag(fieldNumber, WireFormat.WIRETYPE_END_GROUP));
+	    return value;
+	  }
 	
 	  /** Read a {@code bytes} field value from the stream. */
 	  public function readBytes():ByteArray {
@@ -428,12 +460,30 @@ package com.google.protobuf
 	  }
 	
 	  // -----------------------------------------------------------------
-	
+
+	  /**
+	   * The extensions parsed from the extension ranges of the messages,
+	   * the others are skipped like unknown fields. null skips them all.
+	   */
+	  public var extensionRegistry:ExtensionRegistry = ExtensionRegistry.generated;
+
 	  private var bufferSize:int;
 	  private var bufferSizeAfterLimit:int = 0;
 	  private var bufferPos:int = 0;
 	  private var input:IDataInput;
 	  private var lastTag:int = 0;
+
+	  /**
+	   * Bytes consumed so far, the limits are expressed against it.
+	   * Subclasses reading past readRawByte() keep it up to date.
+	   */
+	  protected var totalBytesRead:int = 0;
+
+	  /**
+	   * See pushLimit(), int.MAX_VALUE when there is no limit. Streams
+	   * reading ahead of readRawByte() must not go past it.
+	   */
+	  protected var currentLimit:int = int.MAX_VALUE;
 	
 	  /** See setSizeLimit() */
 	  private var sizeLimit:int = DEFAULT_SIZE_LIMIT;
@@ -456,6 +506,10 @@ package com.google.protobuf
 	  	//lame, wait until buffer is full enough
 	  	//while(bytesAvailable() == 0) {}
 	  	
+	    if (totalBytesRead == currentLimit) {
+	      throw InvalidProtocolBufferException.truncatedMessage();
+	    }
+	    totalBytesRead++;
 	    return input.readByte();
 	  }
 	
@@ -469,11 +523,15 @@ package com.google.protobuf
 	    if (size < 0) {
 	      throw InvalidProtocolBufferException.negativeSize();
 	    }
+	    if (size > currentLimit - totalBytesRead) {
+	      throw InvalidProtocolBufferException.truncatedMessage();
+	    }
 	    
 	    //lame, wait until buffer is full enough
 		//while (bytesAvailable() < size) {}			
 	    
 	    var bytes:ByteArray = new ByteArray();
+	    totalBytesRead += size;
 	    
 	    if(size != 0)
 	      input.readBytes(bytes,0,size);
@@ -489,7 +547,56 @@ package com.google.protobuf
 	   */
 	  public function skipRawBytes(size:int):void 
 	  {
-		readRawBytes(size);
+	    if (size < 0) {
+	      throw InvalidProtocolBufferException.negativeSize();
+	    }
+	    //a ByteArray can just move its position, no need to copy what we throw away
+	    var bytes:ByteArray = input as ByteArray;
+	    if (bytes != null) {
+	      if (size > bytes.bytesAvailable || size > currentLimit - totalBytesRead) {
+	        throw InvalidProtocolBufferException.truncatedMessage();
+	      }
+	      bytes.position += size;
+	      totalBytesRead += size;
+	    }
+	    else
+	      readRawBytes(size);
+	  }
+
+	  /**
+	   * Sets the end of the current embedded message, {@code byteLimit} bytes
+	   * from the current position. readTag() returns 0 once the limit is
+	   * reached, as if the stream ended there.
+	   *
+	   * @return the old limit, to be passed to popLimit().
+	   */
+	  public function pushLimit(byteLimit:int):int {
+	    if (byteLimit < 0) {
+	      throw InvalidProtocolBufferException.negativeSize();
+	    }
+	    byteLimit += totalBytesRead;
+	    var oldLimit:int = currentLimit;
+	    if (byteLimit > oldLimit) {
+	      throw InvalidProtocolBufferException.truncatedMessage();
+	    }
+	    currentLimit = byteLimit;
+	    return oldLimit;
+	  }
+
+	  /** Discards the current limit, returning to the previous one. */
+	  public function popLimit(oldLimit:int):void {
+	    currentLimit = oldLimit;
+	  }
+
+	  /**
+	   * Returns the number of bytes to be read before the current limit,
+	   * or -1 if no limit is set.
+	   */
+	  public function getBytesUntilLimit():int {
+	    if (currentLimit == int.MAX_VALUE) {
+	      return -1;
+	    }
+	    return currentLimit - totalBytesRead;
 	  }
 	}
 }
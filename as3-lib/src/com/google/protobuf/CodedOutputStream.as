@@ -17,6 +17,7 @@
 package com.google.protobuf
 {
 	import flash.utils.ByteArray;
+	import flash.utils.Dictionary;
 	import flash.utils.IDataOutput;
 	
 	/**
@@ -25,12 +26,18 @@ package com.google.protobuf
 	 * @author Robert Blackwood
 	 * -ported from kenton's java implementation
 	 */
-	public final class CodedOutputStream {
+	public class CodedOutputStream {
 	  //private final var buffer:ByteArray;
 	  private var limit:int;
 	  private var position:int;
 	
 	  private var output:IDataOutput;
+
+	  // The sizes of the embedded messages, by message, while a write is in
+	  // progress: computing the size of a message computes the sizes of all
+	  // its embedded ones, which are then written without computing them
+	  // again at every nesting level. See beginWrite().
+	  private static var messageSizes:Dictionary;
 	
 	  /**
 	   * The buffer size used in {@link #newInstance(java.io.OutputStream)}.
@@ -53,7 +60,7 @@ package com.google.protobuf
 	  // -----------------------------------------------------------------
 	
 	  /** Write a {@code double} field, including tag, to the stream. */
-	  public function writeDouble(fieldNumber:int, value:BigInteger):void {
+	  public function writeDouble(fieldNumber:int, value:Number):void {
 	    writeTag(fieldNumber, WireFormat.WIRETYPE_FIXED64);
 	    writeRawDouble(value);
 	    //writeRawLittleEndian64(value);
@@ -115,6 +122,11 @@ package com.google.protobuf
 	  /** Write a {@code string} field, including tag, to the stream. */
 	  public function writeString(fieldNumber:int, value:String):void  {
 	    writeTag(fieldNumber, WireFormat.WIRETYPE_LENGTH_DELIMITED);
+	    writeStringNoTag(value);
+	  }
+
+	  /** Write a {@code string} field to the stream, without the tag. */
+	  public function writeStringNoTag(value:String):void  {
 	    // Not sure if size() on value is reliable because we actually
 	    // want the number of bytes first... not the number of characters
 	    // which may be more than one byte (kenton did this too for java) -rkb
@@ -139,19 +151,44 @@ package com.google.protobuf
 	  }*/
 	
 	  /** Write an embedded message field, including tag, to the stream. */
-	  public function writeMessage(fieldNumber:int, value:Message):void {
+	  public function writeMessage(fieldNumber:int, value:Message, mask:FieldMask = null):void {
 	    writeTag(fieldNumber, WireFormat.WIRETYPE_LENGTH_DELIMITED);
+	    writeMessageNoTag(value, mask);
+	  }
+
+	  /**
+	   * Write an embedded message field to the stream, without the tag.
+	   * Whole messages are written in place after their computed size,
+	   * masked ones are encoded aside first to learn their size.
+	   */
+	  public function writeMessageNoTag(value:Message, mask:FieldMask = null):void {
+	    if (mask == null) {
+	      var started:Boolean = beginWrite();
+	      try {
+	        var size:* = messageSizes[value];
+	        writeRawVarint32(size !== undefined ? size : value.getSerializedSize());
+	        value.writeToCodedStream(this);
+	      } finally {
+	        endWrite(started);
+	      }
+	      return;
+	    }
 	    var tempStream:ByteArray = new ByteArray();
-	    value.writeToDataOutput(tempStream);
+	    value.writeToDataOutput(tempStream, mask);
 	    tempStream.position = 0;
 	    writeRawVarint32(tempStream.length);
-	    output.writeBytes(tempStream,0,tempStream.length);
+	    writeRawBytesPartial(tempStream, 0, tempStream.length);
 	  }
 	  
 	
 	  /** Write a {@code bytes} field, including tag, to the stream. */
 	  public function writeBytes(fieldNumber:int, value:ByteArray):void {
 	    writeTag(fieldNumber, WireFormat.WIRETYPE_LENGTH_DELIMITED);
+	    writeBytesNoTag(value);
+	  }
+
+	  /** Write a {@code bytes} field to the stream, without the tag. */
+	  public function writeBytesNoTag(value:ByteArray):void {
 	    value.position = 0;
 	    writeRawVarint32(value.length);
 	    writeRawBytes(value);
@@ -253,6 +290,11 @@ package com.google.protobuf
 	    	
 	  }
 	  
+	  /**
+	   * The size of what writeField() writes for the value, whose type is
+	   * guessed from its class. The codecs of Message size fields by their
+	   * declared type instead.
+	   */
 	  public static function computeFieldSize(number:int, value:*):int {
 	    
 	    if (value is String)
@@ -263,10 +305,20 @@ package com.google.protobuf
 	    	return computeUInt32Size(number, (value as uint));
 	    else if (value is int)
 	     	return computeInt32Size(number, (value as int));
-	    else if (value is Number)
+	    else if (value is BigInteger)
 	    	return computeInt64Size(number, (value as BigInteger));
+	    else if (value is Number)
+	    	return computeDoubleSize(number, (value as Number));
+	    else if (value is ByteArray)
+	    	return computeBytesSize(number, (value as ByteArray));
 	    else if ( value is Message )
-		    return value.getSerializedSize();	
+		    return computeMessageSize(number, (value as Message));
+	    else if (value is Array) {
+	    	var size:int = 0;
+	    	for each (var elem:* in value)
+	    		size += computeFieldSize(number, elem);
+	    	return size;
+	    }
 	    else
 	    	throw  new InvalidProtocolBufferException( "Could not compute size of field, type was not valid");
 	  }
@@ -367,12 +419,17 @@ package com.google.protobuf
 	   * {@code string} field, including tag.
 	   */
 	  public static function computeStringSize(fieldNumber:int, value:String):int {
+	    return computeTagSize(fieldNumber) + computeStringSizeNoTag(value);
+	  }
 
+	  /**
+	   * Compute the number of bytes that would be needed to encode a
+	   * {@code string} field, without the tag.
+	   */
+	  public static function computeStringSizeNoTag(value:String):int {
 	    var bytes:ByteArray = new ByteArray();
 	    bytes.writeUTFBytes(value);
-	    return computeTagSize(fieldNumber) +
-	           computeRawVarint32Size(bytes.length) +
-	           bytes.length;
+	    return computeRawVarint32Size(bytes.length) + bytes.length;
 	  }
 	
 	  /**
@@ -397,8 +454,37 @@ package com.google.protobuf
 	   * embedded message field, including tag.
 	   */
 	  public static function computeMessageSize(fieldNumber:int, value:Message):int {
+	    return computeTagSize(fieldNumber) + computeMessageSizeNoTag(value);
+	  }
+
+	  /**
+	   * Compute the number of bytes that would be needed to encode an
+	   * embedded message field, without the tag.
+	   */
+	  public static function computeMessageSizeNoTag(value:Message):int {
 	    var size:int = value.getSerializedSize();
-	    return computeTagSize(fieldNumber) + computeRawVarint32Size(size) + size;
+	    if (messageSizes != null)
+	      messageSizes[value] = size;
+	    return computeRawVarint32Size(size) + size;
+	  }
+
+	  /**
+	   * Starts remembering the sizes of the embedded messages computed until
+	   * the matching endWrite(), which must be called even if the write
+	   * fails. Returns whether this call started it, nested writes share
+	   * the outer one. The messages must not change in between.
+	   */
+	  internal static function beginWrite():Boolean {
+	    if (messageSizes != null)
+	      return false;
+	    messageSizes = new Dictionary();
+	    return true;
+	  }
+
+	  /** Forgets the remembered sizes, if started by the matching beginWrite(). */
+	  internal static function endWrite(started:Boolean):void {
+	    if (started)
+	      messageSizes = null;
 	  }
 	
 	  /**
@@ -406,10 +492,16 @@ package com.google.protobuf
 	   * {@code bytes} field, including tag.
 	   */
 	  public static function computeBytesSize(fieldNumber:int, value:ByteArray):int {
+	    return computeTagSize(fieldNumber) + computeBytesSizeNoTag(value);
+	  }
+
+	  /**
+	   * Compute the number of bytes that would be needed to encode a
+	   * {@code bytes} field, without the tag.
+	   */
+	  public static function computeBytesSizeNoTag(value:ByteArray):int {
 	  	var len:int = value.length;
-	  	
-	    return computeTagSize(fieldNumber) +
-	           computeRawVarint32Size(len) + len;
+	    return computeRawVarint32Size(len) + len;
 	  }
 	
 	  /**
@@ -493,6 +585,13 @@ package com.google.protobuf
 	  // =================================================================
 	
 	
+	  /**
+	   * Writes out whatever the stream buffered. This one writes through,
+	   * subclasses which buffer override it.
+	   */
+	  public function flush():void {
+	  }
+
 	  /** Write a single byte, represented by an integer value. */
 	  public function writeRawByte(value:int):void {
 	    output.writeByte(value);
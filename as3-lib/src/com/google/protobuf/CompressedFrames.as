@@ -0,0 +1,97 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.utils.ByteArray;
+	import flash.utils.IDataInput;
+	import flash.utils.IDataOutput;
+
+	/**
+	 * Optional compression of messages, with ByteArray.compress(): the
+	 * encoded messages of at least threshold bytes are zlib compressed,
+	 * when that makes them smaller, and tagged so the reader knows.
+	 *
+	 * In a stream, a frame is a varint header, (payload size << 1) |
+	 * compressed, followed by the payload. A whole message, see
+	 * toByteArray(), is one flag byte, 0 or 1, followed by the payload.
+	 * as3frames, built with the compiler, reads and writes the same
+	 * frames on the server side.
+	 */
+	public final class CompressedFrames {
+
+	  public static const DEFAULT_THRESHOLD:int = 1024;
+
+	  /** Writes the message as one frame of a stream. */
+	  public static function writeDelimited(output:IDataOutput, message:Message,
+	                                        threshold:int = DEFAULT_THRESHOLD):void {
+	  	var payload:ByteArray = message.toByteArray();
+	  	var packed:ByteArray = compress(payload, threshold);
+	  	var coded:CodedOutputStream = CodedOutputStream.newInstance(output);
+	  	coded.writeRawVarint32((packed.length << 1) | (packed != payload ? 1 : 0));
+	  	coded.writeRawBytes(packed);
+	  	coded.flush();
+	  }
+
+	  /** Reads the next frame of a stream into the message. */
+	  public static function readDelimited(input:IDataInput, message:Message):void {
+	  	var coded:CodedInputStream = CodedInputStream.newInstance(input);
+	  	var header:int = coded.readRawVarint32();
+	  	var payload:ByteArray = coded.readRawBytes(header >>> 1);
+	  	if ((header & 1) != 0)
+	  		payload.uncompress();
+	  	payload.position = 0;
+	  	message.readFromDataOutput(payload);
+	  }
+
+	  /** The message alone, behind its flag byte. */
+	  public static function toByteArray(message:Message,
+	                                     threshold:int = DEFAULT_THRESHOLD):ByteArray {
+	  	var payload:ByteArray = message.toByteArray();
+	  	var packed:ByteArray = compress(payload, threshold);
+	  	var result:ByteArray = new ByteArray();
+	  	result.writeByte(packed != payload ? 1 : 0);
+	  	result.writeBytes(packed);
+	  	result.position = 0;
+	  	return result;
+	  }
+
+	  /** Merges what toByteArray() returned into the message. */
+	  public static function mergeFrom(message:Message, bytes:ByteArray):void {
+	  	var flag:int = bytes.readByte();
+	  	if (flag != 0 && flag != 1)
+	  		throw new InvalidProtocolBufferException("Unknown compression flag " + flag + ".");
+	  	var payload:ByteArray = bytes;
+	  	if (flag == 1) {
+	  		payload = new ByteArray();
+	  		bytes.readBytes(payload);
+	  		payload.uncompress();
+	  		payload.position = 0;
+	  	}
+	  	message.readFromDataOutput(payload);
+	  }
+
+	  /** Returns the compressed payload, or payload when not worth it. */
+	  private static function compress(payload:ByteArray, threshold:int):ByteArray {
+	  	if (payload.length < threshold)
+	  		return payload;
+	  	var packed:ByteArray = new ByteArray();
+	  	packed.writeBytes(payload);
+	  	packed.compress();
+	  	return packed.length < payload.length ? packed : payload;
+	  }
+	}
+}
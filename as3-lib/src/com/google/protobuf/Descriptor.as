@@ -16,6 +16,8 @@
 
 package com.google.protobuf
 {
+	import flash.utils.getQualifiedClassName;
+	
 	/**
 	 * Descriptors are used for reflection and obtaining protocol
 	 * buffer specific information about a field.
@@ -64,14 +66,21 @@ package com.google.protobuf
  		public var label:int;
  		public var fieldNumber:int;
  		public var type:int;
- 		public var messageClass:String;
+ 		public var messageType:Class;
+ 		/** The name of the field in text format, as in the .proto file. */
+ 		public var textName:String;
+ 		/** The lowerCamelCase name of the field in JSON. */
+ 		public var jsonName:String;
  		
- 		public function Descriptor(name:String, messageClass:String, type:int, label:int, fieldNumber:int) {
+ 		public function Descriptor(name:String, messageType:Class, type:int, label:int, fieldNumber:int, textName:String = null) {
 			this.fieldName = name;
-			this.messageClass = messageClass;
+			this.messageType = messageType;
 			this.type = type;
  			this.label = label;
  			this.fieldNumber = fieldNumber;
+ 			//guessed from the property name for hand written messages
+ 			this.textName = textName != null ? textName : TextFormat.textFieldName(name, type, messageType);
+ 			this.jsonName = JsonWriter.jsonFieldName(protoName);
  		}
  		
  		public function isOptional():Boolean { return label == LABEL_OPTIONAL; }
@@ -79,6 +88,18 @@ package com.google.protobuf
  		public function isRepeated():Boolean { return label == LABEL_REPEATED; }
  		public function isMessage():Boolean  { return type == MESSAGE; }
  		
+ 		/** The name of the field in the .proto file, lower cased for groups. */
+ 		public function get protoName():String {
+ 			return type == GROUP ? textName.toLowerCase() : textName;
+ 		}
+ 		
+ 		/** Fully qualified name of the class of message fields, "" otherwise. */
+ 		public function get messageClass():String {
+ 			if (messageType == null)
+ 				return "";
+ 			return getQualifiedClassName(messageType).replace("::", ".");
+ 		}
+ 		
  	}
  	
  	
@@ -0,0 +1,39 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	/**
+	 * Describes an extension: a field declared outside of the message it
+	 * extends, within one of its extension ranges. The generated code
+	 * holds one in a static constant per extension, see
+	 * Message.setExtension().
+	 */
+	public class ExtensionDescriptor extends Descriptor {
+
+	  /** The class of the extended message. */
+	  public var containingType:Class;
+	  /** The tag of the extension, wire type included. */
+	  public var tag:int;
+
+	  /** name is the full name of the extension, as in the .proto file. */
+	  public function ExtensionDescriptor(name:String, containingType:Class, messageType:Class, type:int, label:int, fieldNumber:int) {
+	  	super(name, messageType, type, label, fieldNumber);
+	  	this.containingType = containingType;
+	  	this.tag = WireFormat.makeTag(fieldNumber, WireFormat.getWireTypeForFieldType(type));
+	  }
+	}
+}
@@ -0,0 +1,63 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.utils.Dictionary;
+
+	/**
+	 * The extensions known to the parser, looked up by the class of the
+	 * extended message and field number in constant time: a dictionary
+	 * of sparse arrays indexed by field number.
+	 *
+	 * Generated extensions add themselves to the generated registry when
+	 * the class declaring them is initialized, that is when one of them is
+	 * first used, or when registerAllExtensions() of their file is called.
+	 * Streams use the generated registry unless given another one, see
+	 * CodedInputStream.extensionRegistry.
+	 */
+	public final class ExtensionRegistry {
+
+	  private static const generatedRegistry:ExtensionRegistry = new ExtensionRegistry();
+
+	  // extended message Class -> Array of ExtensionDescriptors, by field number
+	  private var extensions:Dictionary = new Dictionary();
+
+	  /** The registry the generated extensions add themselves to. */
+	  public static function get generated():ExtensionRegistry {
+	  	return generatedRegistry;
+	  }
+
+	  /** Adds the extension, replacing the one with the same number. */
+	  public function add(extension:ExtensionDescriptor):ExtensionDescriptor {
+	  	var byNumber:Array = extensions[extension.containingType];
+	  	if (byNumber == null) {
+	  		byNumber = new Array();
+	  		extensions[extension.containingType] = byNumber;
+	  	}
+	  	byNumber[extension.fieldNumber] = extension;
+	  	return extension;
+	  }
+
+	  /** The extension of the given message class and number, or null. */
+	  public function find(containingType:Class, fieldNumber:int):ExtensionDescriptor {
+	  	var byNumber:Array = extensions[containingType];
+	  	if (byNumber == null)
+	  		return null;
+	  	return byNumber[fieldNumber];
+	  }
+	}
+}
@@ -0,0 +1,113 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	/**
+	 * Selects a subset of the fields of a message, in the spirit of
+	 * google.protobuf.FieldMask. Paths are dot separated field names,
+	 * e.g. "player.position", and may use either the .proto spelling
+	 * (player_info) or the actionscript one (playerInfo). The names are
+	 * matched against the registered descriptors when the mask is
+	 * applied, since a .proto name cannot be turned into the actionscript
+	 * one without them (value2x is value2X).
+	 *
+	 * A mask is passed to Message.writeToCodedStream() to write only the
+	 * selected fields, and to Message.readFromCodedStream() to skip the
+	 * unselected ones on the wire without materializing them.
+	 *
+	 * Selecting a message field without sub path selects the whole
+	 * sub message.
+	 */
+	public final class FieldMask {
+
+	  // path segment -> sub mask, null when the whole field is selected
+	  private var children:Object = {};
+
+	  public function FieldMask(paths:Array = null) {
+	  	for each (var path:String in paths)
+	  		addPath(path);
+	  }
+
+	  /**
+	   * Builds a mask from a comma separated path list,
+	   * e.g. "name,player.position".
+	   */
+	  public static function fromString(paths:String):FieldMask {
+	  	var mask:FieldMask = new FieldMask();
+	  	for each (var path:String in paths.split(",")) {
+	  		if (path.length != 0)
+	  			mask.addPath(path);
+	  	}
+	  	return mask;
+	  }
+
+	  /** Adds one dot separated path to the mask. */
+	  public function addPath(path:String):FieldMask {
+	  	var node:FieldMask = this;
+	  	var names:Array = path.split(".");
+	  	for (var i:int = 0; i < names.length; i++) {
+	  		var name:String = names[i];
+	  		var last:Boolean = i == names.length - 1;
+	  		if (!node.children.hasOwnProperty(name)) {
+	  			node.children[name] = last ? null : new FieldMask();
+	  		} else if (node.children[name] == null) {
+	  			// a parent path already selects the whole field
+	  			return this;
+	  		} else if (last) {
+	  			node.children[name] = null;
+	  			return this;
+	  		}
+	  		node = node.children[name];
+	  	}
+	  	return this;
+	  }
+
+	  /** True if the field of the given descriptor is selected. */
+	  public function includes(desc:Descriptor):Boolean {
+	  	return segmentOf(desc) != null;
+	  }
+
+	  /**
+	   * The mask to apply to a selected message or group field, or null
+	   * if the whole sub message is selected.
+	   */
+	  public function getSubMask(desc:Descriptor):FieldMask {
+	  	var segment:String = segmentOf(desc);
+	  	return segment == null ? null : children[segment];
+	  }
+
+	  /**
+	   * The path segment selecting the field: its actionscript name, its
+	   * text format name, or for groups the lower case field name of the
+	   * .proto file. A segment selecting the whole field wins.
+	   */
+	  private function segmentOf(desc:Descriptor):String {
+	  	var found:String = null;
+	  	var names:Array = [desc.fieldName, desc.textName];
+	  	if (desc.type == Descriptor.GROUP)
+	  		names.push(desc.textName.toLowerCase());
+	  	for each (var name:String in names) {
+	  		if (!children.hasOwnProperty(name))
+	  			continue;
+	  		if (children[name] == null)
+	  			return name;
+	  		found = name;
+	  	}
+	  	return found;
+	  }
+	}
+}
@@ -0,0 +1,357 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	/**
+	 * Compact description of the fields of a message, used by the messages
+	 * generated for CODE_SIZE files instead of per message codec code.
+	 *
+	 * Each field is one row of ROW_SIZE ints in {@code rows}: its tag (the
+	 * wire type being the low bits), its Descriptor type and its
+	 * Descriptor label. Rows are sorted by field number. The row index is
+	 * the slot of the field in {@code names} (the property holding it),
+	 * {@code textNames} (its name in the .proto file, the type name for
+	 * groups), {@code jsonNames} (its lowerCamelCase JSON name, derived by
+	 * protoc from the .proto name) and {@code classes} (the class of
+	 * message fields, the value names of enum fields, null otherwise).
+	 *
+	 * The messages hold their field values in an Array by slot, see
+	 * Message.fieldValues, which the codecs index directly: looking the
+	 * properties up by name costs a string lookup per field. The names are
+	 * only used by the text format and JSON codecs, whose parsers set the
+	 * fields through the generated accessors.
+	 *
+	 * A table is built once per message class and shared by all instances.
+	 */
+	public final class FieldTable {
+
+	  public static const ROW_SIZE:int = 3;
+
+	  private var rows:Vector.<int>;
+	  private var names:Vector.<String>;
+	  private var textNames:Vector.<String>;
+	  private var jsonNames:Vector.<String>;
+	  private var classes:Array;
+	  private var count:int;
+
+	  // The slots by text format name
+	  private var slotsByTextName:Object;
+	  // The slots by JSON name, or .proto name
+	  private var slotsByName:Object;
+
+	  public function FieldTable(rows:Vector.<int>, names:Vector.<String>, textNames:Vector.<String>, jsonNames:Vector.<String>, classes:Array) {
+	  	this.rows = rows;
+	  	this.names = names;
+	  	this.textNames = textNames;
+	  	this.jsonNames = jsonNames;
+	  	this.classes = classes;
+	  	this.count = names.length;
+	  }
+
+	  /**
+	   * Writes all the set fields of the message, and its extensions in
+	   * between, in field number order.
+	   */
+	  public function writeTo(message:Message, values:Array, output:CodedOutputStream):void {
+	  	var written:int = 0; //the extensions below this number are written
+	  	for (var slot:int = 0; slot < count; slot++) {
+	  		var row:int = slot * ROW_SIZE;
+	  		var tag:int = rows[row];
+	  		var type:int = rows[row + 1];
+	  		var value:* = values[slot];
+
+	  		var number:int = WireFormat.getTagFieldNumber(tag);
+	  		message.writeExtensions(output, written, number);
+	  		written = number;
+
+	  		if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  			for each (var elem:* in value) {
+	  				output.writeRawVarint32(tag);
+	  				writeValue(output, tag, type, elem);
+	  			}
+	  		} else if (isSet(type, value)) {
+	  			output.writeRawVarint32(tag);
+	  			writeValue(output, tag, type, value);
+	  		}
+	  	}
+	  	message.writeExtensions(output, written, int.MAX_VALUE);
+	  }
+
+	  /** Computes the number of bytes writeTo() would write. */
+	  public function getSerializedSize(message:Message, values:Array):int {
+	  	var size:int = 0;
+	  	for (var slot:int = 0; slot < count; slot++) {
+	  		var row:int = slot * ROW_SIZE;
+	  		var tagSize:int = CodedOutputStream.computeRawVarint32Size(rows[row]);
+	  		var type:int = rows[row + 1];
+	  		var value:* = values[slot];
+
+	  		if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  			for each (var elem:* in value) {
+	  				size += tagSize + computeValueSize(tagSize, type, elem);
+	  			}
+	  		} else if (isSet(type, value)) {
+	  			size += tagSize + computeValueSize(tagSize, type, value);
+	  		}
+	  	}
+	  	return size + message.getExtensionsSerializedSize();
+	  }
+
+	  /**
+	   * Merges fields read from the stream into the message, until the end
+	   * of the stream, the current limit or an end group tag.
+	   */
+	  public function readFrom(message:Message, values:Array, input:CodedInputStream):void {
+	  	var slot:int = 0;
+	  	var tag:int;
+	  	while ((tag = input.readTag()) != 0) {
+	  		slot = findSlot(tag, slot);
+	  		if (slot < 0) {
+	  			if (!message.readExtension(input, tag))
+	  				return; //end group tag
+	  			slot = 0;
+	  			continue;
+	  		}
+
+	  		var row:int = slot * ROW_SIZE;
+	  		var type:int = rows[row + 1];
+
+	  		if (type == Descriptor.MESSAGE || type == Descriptor.GROUP) {
+	  			var item:Message;
+	  			if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  				item = new classes[slot]();
+	  				values[slot].push(item);
+	  			} else {
+	  				//merge a field seen twice
+	  				item = values[slot];
+	  				if (item == null || item.isFrozen) {
+	  					item = new classes[slot]();
+	  					values[slot] = item;
+	  				}
+	  			}
+	  			if (type == Descriptor.MESSAGE)
+	  				input.readMessage(item);
+	  			else
+	  				input.readGroup(WireFormat.getTagFieldNumber(tag), item);
+	  		} else if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  			values[slot].push(input.readPrimitiveField(type));
+	  		} else {
+	  			values[slot] = input.readPrimitiveField(type);
+	  		}
+	  	}
+	  }
+
+	  /** Prints all the set fields of the message, in field number order. */
+	  public function writeText(message:Message, values:Array, output:TextWriter):void {
+	  	for (var slot:int = 0; slot < count; slot++) {
+	  		var row:int = slot * ROW_SIZE;
+	  		var type:int = rows[row + 1];
+	  		var value:* = values[slot];
+
+	  		if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  			for each (var elem:* in value)
+	  				output.printValue(textNames[slot], type, elem, classes[slot]);
+	  		} else if (isSet(type, value)) {
+	  			output.printValue(textNames[slot], type, value, classes[slot]);
+	  		}
+	  	}
+	  }
+
+	  /**
+	   * Merges fields read from the tokenizer into the message, up to the
+	   * end of the text or of the enclosing message.
+	   */
+	  public function readText(message:Message, input:TextTokenizer):void {
+	  	initSlotsByName();
+	  	while (!input.atMessageEnd()) {
+	  		var name:String = input.consumeIdentifier();
+	  		if (!slotsByTextName.hasOwnProperty(name))
+	  			throw input.parseError("Message has no field named \"" + name + "\".");
+	  		var slot:int = slotsByTextName[name];
+	  		var row:int = slot * ROW_SIZE;
+	  		input.consumeField(message, names[slot], rows[row + 1],
+	  		                   rows[row + 2] == Descriptor.LABEL_REPEATED, classes[slot]);
+	  	}
+	  }
+
+	  /** Writes all the set fields of the message as JSON object members. */
+	  public function writeJSON(message:Message, values:Array, output:JsonWriter):void {
+	  	for (var slot:int = 0; slot < count; slot++) {
+	  		var row:int = slot * ROW_SIZE;
+	  		var type:int = rows[row + 1];
+	  		var value:* = values[slot];
+
+	  		if (rows[row + 2] == Descriptor.LABEL_REPEATED) {
+	  			if (value.length == 0)
+	  				continue;
+	  			output.beginArray(jsonNames[slot]);
+	  			for each (var elem:* in value)
+	  				output.writeValue(null, type, elem, classes[slot]);
+	  			output.endArray();
+	  		} else if (isSet(type, value)) {
+	  			output.writeValue(jsonNames[slot], type, value, classes[slot]);
+	  		}
+	  	}
+	  }
+
+	  /**
+	   * Merges the members of an Object built by JSON.parse() into the
+	   * message, by JSON or .proto name.
+	   */
+	  public function readJSON(message:Message, object:Object):void {
+	  	initSlotsByName();
+	  	for (var name:String in object) {
+	  		if (!slotsByName.hasOwnProperty(name))
+	  			throw new InvalidProtocolBufferException("Message has no field named \"" + name + "\".");
+	  		var slot:int = slotsByName[name];
+	  		var row:int = slot * ROW_SIZE;
+	  		JsonReader.readField(message, names[slot], rows[row + 1],
+	  		                     rows[row + 2] == Descriptor.LABEL_REPEATED, classes[slot], object[name]);
+	  	}
+	  }
+
+	  /**
+	   * Builds the slots by text format and JSON name, the first time they
+	   * are needed.
+	   */
+	  private function initSlotsByName():void {
+	  	if (slotsByTextName != null)
+	  		return;
+	  	slotsByTextName = new Object();
+	  	slotsByName = new Object();
+	  	for (var slot:int = 0; slot < count; slot++) {
+	  		slotsByTextName[textNames[slot]] = slot;
+	  		slotsByName[jsonNames[slot]] = slot;
+	  		//the .proto name of groups is the lower cased type name
+	  		if (rows[slot * ROW_SIZE + 1] == Descriptor.GROUP)
+	  			slotsByName[textNames[slot].toLowerCase()] = slot;
+	  		else
+	  			slotsByName[textNames[slot]] = slot;
+	  	}
+	  }
+
+	  /**
+	   * Returns the slot of the field with the given tag, or -1. Fields
+	   * usually come in order, so the search starts at the given slot.
+	   */
+	  private function findSlot(tag:int, start:int):int {
+	  	var slot:int;
+	  	for (slot = start; slot < count; slot++) {
+	  		if (rows[slot * ROW_SIZE] == tag)
+	  			return slot;
+	  	}
+	  	for (slot = 0; slot < start; slot++) {
+	  		if (rows[slot * ROW_SIZE] == tag)
+	  			return slot;
+	  	}
+	  	return -1;
+	  }
+
+	  /** Same presence rules as the generated SPEED codecs. */
+	  private static function isSet(type:int, value:*):Boolean {
+	  	if (type == Descriptor.ENUM)
+	  		return value != -1;
+	  	return value != null;
+	  }
+
+	  internal static function writeValue(output:CodedOutputStream, tag:int, type:int, value:*):void {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.UINT32:
+	  		case Descriptor.ENUM:
+	  			output.writeRawVarint32(value);
+	  			break;
+	  		case Descriptor.SINT32:
+	  			output.writeRawVarint32(CodedOutputStream.encodeZigZag32(value));
+	  			break;
+	  		case Descriptor.FIXED32:
+	  		case Descriptor.SFIXED32:
+	  			output.writeRawLittleEndian32(value);
+	  			break;
+	  		case Descriptor.INT64:
+	  		case Descriptor.UINT64:
+	  			output.writeRawVarint64(value);
+	  			break;
+	  		case Descriptor.SINT64:
+	  			output.writeRawVarint64(CodedOutputStream.encodeZigZag64(value));
+	  			break;
+	  		case Descriptor.FIXED64:
+	  		case Descriptor.SFIXED64:
+	  			output.writeRawLittleEndian64(value);
+	  			break;
+	  		case Descriptor.FLOAT:
+	  			output.writeRawFloat(value);
+	  			break;
+	  		case Descriptor.DOUBLE:
+	  			output.writeRawDouble(value);
+	  			break;
+	  		case Descriptor.BOOL:
+	  			output.writeRawByte(value ? 1 : 0);
+	  			break;
+	  		case Descriptor.STRING:
+	  			output.writeStringNoTag(value);
+	  			break;
+	  		case Descriptor.BYTES:
+	  			output.writeBytesNoTag(value);
+	  			break;
+	  		case Descriptor.MESSAGE:
+	  			output.writeMessageNoTag(value);
+	  			break;
+	  		case Descriptor.GROUP:
+	  			value.writeToCodedStream(output);
+	  			//the end tag only differs by its wire type
+	  			output.writeRawVarint32(tag + 1);
+	  			break;
+	  	}
+	  }
+
+	  internal static function computeValueSize(tagSize:int, type:int, value:*):int {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.UINT32:
+	  		case Descriptor.ENUM:
+	  			return CodedOutputStream.computeRawVarint32Size(value);
+	  		case Descriptor.SINT32:
+	  			return CodedOutputStream.computeRawVarint32Size(CodedOutputStream.encodeZigZag32(value));
+	  		case Descriptor.INT64:
+	  		case Descriptor.UINT64:
+	  			return CodedOutputStream.computeRawVarint64Size(value);
+	  		case Descriptor.SINT64:
+	  			return CodedOutputStream.computeRawVarint64Size(CodedOutputStream.encodeZigZag64(value));
+	  		case Descriptor.FIXED32:
+	  		case Descriptor.SFIXED32:
+	  		case Descriptor.FLOAT:
+	  			return 4;
+	  		case Descriptor.FIXED64:
+	  		case Descriptor.SFIXED64:
+	  		case Descriptor.DOUBLE:
+	  			return 8;
+	  		case Descriptor.BOOL:
+	  			return 1;
+	  		case Descriptor.STRING:
+	  			return CodedOutputStream.computeStringSizeNoTag(value);
+	  		case Descriptor.BYTES:
+	  			return CodedOutputStream.computeBytesSizeNoTag(value);
+	  		case Descriptor.MESSAGE:
+	  			return CodedOutputStream.computeMessageSizeNoTag(value);
+	  		case Descriptor.GROUP:
+	  			return tagSize + value.getSerializedSize();
+	  	}
+	  	return 0;
+	  }
+	}
+}
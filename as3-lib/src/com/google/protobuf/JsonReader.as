@@ -0,0 +1,193 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import com.hurlant.math.BigInteger;
+	import com.hurlant.util.Base64;
+	import flash.utils.ByteArray;
+
+	/**
+	 * Converts the values of an Object built by JSON.parse() to field
+	 * values, following the proto3 JSON mapping. Used by the generated
+	 * fromJSONObject() methods and by the reflective one of Message.
+	 *
+	 * Values of the wrong kind throw an InvalidProtocolBufferException.
+	 */
+	public final class JsonReader {
+
+	  /** int32, sint32 and sfixed32 values, from a number or a string. */
+	  public static function parseInt32(value:*):int {
+	  	return parseInteger(value, Descriptor.INT32);
+	  }
+
+	  /** uint32 and fixed32 values, held in an int. */
+	  public static function parseUInt32(value:*):int {
+	  	return parseInteger(value, Descriptor.UINT32);
+	  }
+
+	  /** int64 and sfixed64 values, in two's complement when negative. */
+	  public static function parseInt64(value:*):BigInteger {
+	  	return parseInteger(value, Descriptor.INT64);
+	  }
+
+	  public static function parseSInt64(value:*):BigInteger {
+	  	return parseInteger(value, Descriptor.SINT64);
+	  }
+
+	  public static function parseUInt64(value:*):BigInteger {
+	  	return parseInteger(value, Descriptor.UINT64);
+	  }
+
+	  /** Numbers, numeric strings, "NaN", "Infinity" and "-Infinity". */
+	  public static function parseDouble(value:*):Number {
+	  	if (value is Number)
+	  		return value;
+	  	if (value == "NaN")
+	  		return Number.NaN;
+	  	if (value == "Infinity")
+	  		return Number.POSITIVE_INFINITY;
+	  	if (value == "-Infinity")
+	  		return Number.NEGATIVE_INFINITY;
+	  	var result:Number = (value is String && value != "") ? Number(value) : Number.NaN;
+	  	if (isNaN(result))
+	  		throw error("number", value);
+	  	return result;
+	  }
+
+	  public static function parseBool(value:*):Boolean {
+	  	if (!(value is Boolean))
+	  		throw error("boolean", value);
+	  	return value;
+	  }
+
+	  public static function parseString(value:*):String {
+	  	if (!(value is String))
+	  		throw error("string", value);
+	  	return value;
+	  }
+
+	  /** Standard or URL safe base64. */
+	  public static function parseBytes(value:*):ByteArray {
+	  	var text:String = parseString(value).replace(/-/g, "+").replace(/_/g, "/");
+	  	return Base64.decodeToByteArray(text);
+	  }
+
+	  /**
+	   * An enum value, by name or by number. names maps the numbers of the
+	   * values to their names, as generated for enum fields.
+	   */
+	  public static function parseEnum(value:*, names:Object):int {
+	  	if (!(value is String))
+	  		return parseInt32(value);
+	  	var numbers:Object = TextFormat.enumValueNumbers(names);
+	  	if (!numbers.hasOwnProperty(value))
+	  		throw new InvalidProtocolBufferException(
+	  			"Unknown enumeration value \"" + value + "\".");
+	  	return numbers[value];
+	  }
+
+	  /** The value of a repeated field. */
+	  public static function parseArray(value:*):Array {
+	  	if (!(value is Array))
+	  		throw error("array", value);
+	  	return value;
+	  }
+
+	  /**
+	   * Converts a value of the given Descriptor type, names being the
+	   * value names of enum fields. Used by the reflective readers.
+	   */
+	  public static function parseValue(type:int, value:*, names:Object = null):* {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.SINT32:
+	  		case Descriptor.SFIXED32:
+	  			return parseInt32(value);
+	  		case Descriptor.UINT32:
+	  		case Descriptor.FIXED32:
+	  			return parseUInt32(value);
+	  		case Descriptor.INT64:
+	  		case Descriptor.SFIXED64:
+	  			return parseInt64(value);
+	  		case Descriptor.SINT64:
+	  			return parseSInt64(value);
+	  		case Descriptor.UINT64:
+	  		case Descriptor.FIXED64:
+	  			return parseUInt64(value);
+	  		case Descriptor.FLOAT:
+	  		case Descriptor.DOUBLE:
+	  			return parseDouble(value);
+	  		case Descriptor.BOOL:
+	  			return parseBool(value);
+	  		case Descriptor.STRING:
+	  			return parseString(value);
+	  		case Descriptor.BYTES:
+	  			return parseBytes(value);
+	  		case Descriptor.ENUM:
+	  			return parseEnum(value, names);
+	  	}
+	  	throw new InvalidProtocolBufferException("Unsupported field type " + type + ".");
+	  }
+
+	  /**
+	   * Merges the JSON value of a field into the property of the message
+	   * holding it. messageType is the class of message fields, the value
+	   * names of enum fields.
+	   */
+	  public static function readField(message:Message, property:String, type:int,
+	                                   repeated:Boolean, messageType:*, value:*):void {
+	  	if (value == null)
+	  		return; //null stands for the default value
+	  	var isMessage:Boolean = type == Descriptor.MESSAGE || type == Descriptor.GROUP;
+	  	if (repeated) {
+	  		for each (var element:* in parseArray(value)) {
+	  			if (isMessage) {
+	  				var item:Message = new messageType();
+	  				item.fromJSONObject(element);
+	  				message[property].push(item);
+	  			} else {
+	  				message[property].push(parseValue(type, element, messageType));
+	  			}
+	  		}
+	  	} else if (isMessage) {
+	  		if (message[property] == null || message[property].isFrozen)
+	  			message[property] = new messageType();
+	  		message[property].fromJSONObject(value);
+	  	} else {
+	  		message[property] = parseValue(type, value, messageType);
+	  	}
+	  }
+
+	  // -----------------------------------------------------------------
+
+	  /** Integers are parsed like in text format, which also checks ranges. */
+	  private static function parseInteger(value:*, type:int):* {
+	  	if (!(value is Number) && !(value is String))
+	  		throw error("integer", value);
+	  	var input:TextTokenizer = new TextTokenizer(String(value));
+	  	var result:* = input.consumeValue(type);
+	  	if (!input.atEnd())
+	  		throw error("integer", value);
+	  	return result;
+	  }
+
+	  private static function error(expected:String, value:*):InvalidProtocolBufferException {
+	  	return new InvalidProtocolBufferException(
+	  		"Expected " + expected + " in JSON, got " + value + ".");
+	  }
+	}
+}
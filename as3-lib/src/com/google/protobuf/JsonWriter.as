@@ -0,0 +1,234 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import com.hurlant.math.BigInteger;
+	import com.hurlant.util.Base64;
+	import flash.utils.ByteArray;
+
+	/**
+	 * Streams messages as JSON text, following the proto3 JSON mapping:
+	 * lowerCamelCase field names, 64 bit integers as strings, enums by name
+	 * and bytes in base64. The generated writeJSON() methods, and the
+	 * reflective one of Message, write their fields to it. No intermediate
+	 * Object is built, the pieces are only joined by toString().
+	 *
+	 * Every write method takes the name of the field, or null for the
+	 * elements of an array.
+	 */
+	public final class JsonWriter {
+
+	  private var parts:Array = new Array();
+
+	  /**
+	   * The JSON name of a field, derived from its .proto name like protoc
+	   * does: underscores are dropped and the letter following each one is
+	   * upper cased, e.g. "foo_bar" is "fooBar" and "value2x" is kept.
+	   */
+	  public static function jsonFieldName(protoName:String):String {
+	  	var name:String = "";
+	  	var capitalizeNext:Boolean = false;
+	  	for (var i:int = 0; i < protoName.length; i++) {
+	  		var c:String = protoName.charAt(i);
+	  		if (c == "_") {
+	  			capitalizeNext = true;
+	  		} else {
+	  			name += capitalizeNext ? c.toUpperCase() : c;
+	  			capitalizeNext = false;
+	  		}
+	  	}
+	  	return name;
+	  }
+
+	  // Whether the next member or element needs a comma before it
+	  private var needComma:Boolean = false;
+
+	  public function writeInt32(name:String, value:int):void {
+	  	writeRaw(name, String(value));
+	  }
+
+	  /** uint32 and fixed32 values, held in an int. */
+	  public function writeUInt32(name:String, value:int):void {
+	  	writeRaw(name, String(uint(value)));
+	  }
+
+	  /** int64 and sfixed64 values, which the runtime keeps unsigned. */
+	  public function writeInt64(name:String, value:BigInteger):void {
+	  	writeRaw(name, "\"" + TextFormat.int64ToString(value) + "\"");
+	  }
+
+	  public function writeSInt64(name:String, value:BigInteger):void {
+	  	writeInt64(name, value);
+	  }
+
+	  public function writeUInt64(name:String, value:BigInteger):void {
+	  	writeRaw(name, "\"" + TextFormat.uint64ToString(value) + "\"");
+	  }
+
+	  /** JSON has no literal for NaN and the infinities, they are strings. */
+	  public function writeDouble(name:String, value:Number):void {
+	  	if (isNaN(value))
+	  		writeRaw(name, "\"NaN\"");
+	  	else if (value == Number.POSITIVE_INFINITY)
+	  		writeRaw(name, "\"Infinity\"");
+	  	else if (value == Number.NEGATIVE_INFINITY)
+	  		writeRaw(name, "\"-Infinity\"");
+	  	else
+	  		writeRaw(name, String(value));
+	  }
+
+	  public function writeBool(name:String, value:Boolean):void {
+	  	writeRaw(name, value ? "true" : "false");
+	  }
+
+	  public function writeString(name:String, value:String):void {
+	  	writeRaw(name, quote(value));
+	  }
+
+	  public function writeBytes(name:String, value:ByteArray):void {
+	  	writeRaw(name, "\"" + Base64.encodeByteArray(value) + "\"");
+	  }
+
+	  /**
+	   * Writes the name of the enum value, or its number when names, as
+	   * generated for enum fields, does not know it.
+	   */
+	  public function writeEnum(name:String, value:int, names:Object):void {
+	  	var valueName:String = names == null ? null : names[value];
+	  	writeRaw(name, valueName != null ? "\"" + valueName + "\"" : String(value));
+	  }
+
+	  public function writeMessage(name:String, message:Message):void {
+	  	writeName(name);
+	  	parts.push("{");
+	  	needComma = false;
+	  	message.writeJSON(this);
+	  	parts.push("}");
+	  	needComma = true;
+	  }
+
+	  /** Starts the array of a repeated field, see endArray(). */
+	  public function beginArray(name:String):void {
+	  	writeName(name);
+	  	parts.push("[");
+	  	needComma = false;
+	  }
+
+	  public function endArray():void {
+	  	parts.push("]");
+	  	needComma = true;
+	  }
+
+	  /**
+	   * Writes a value of the given Descriptor type, names being the value
+	   * names of enum fields. Used by the reflective writers.
+	   */
+	  public function writeValue(name:String, type:int, value:*, names:Object = null):void {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.SINT32:
+	  		case Descriptor.SFIXED32:
+	  			writeInt32(name, value);
+	  			break;
+	  		case Descriptor.UINT32:
+	  		case Descriptor.FIXED32:
+	  			writeUInt32(name, value);
+	  			break;
+	  		case Descriptor.INT64:
+	  		case Descriptor.SINT64:
+	  		case Descriptor.SFIXED64:
+	  			writeInt64(name, value);
+	  			break;
+	  		case Descriptor.UINT64:
+	  		case Descriptor.FIXED64:
+	  			writeUInt64(name, value);
+	  			break;
+	  		case Descriptor.FLOAT:
+	  		case Descriptor.DOUBLE:
+	  			writeDouble(name, value);
+	  			break;
+	  		case Descriptor.BOOL:
+	  			writeBool(name, value);
+	  			break;
+	  		case Descriptor.STRING:
+	  			writeString(name, value);
+	  			break;
+	  		case Descriptor.BYTES:
+	  			writeBytes(name, value);
+	  			break;
+	  		case Descriptor.ENUM:
+	  			writeEnum(name, value, names);
+	  			break;
+	  		case Descriptor.MESSAGE:
+	  		case Descriptor.GROUP:
+	  			writeMessage(name, value);
+	  			break;
+	  	}
+	  }
+
+	  public function toString():String {
+	  	return parts.join("");
+	  }
+
+	  // -----------------------------------------------------------------
+
+	  /** Writes an already formatted value. */
+	  private function writeRaw(name:String, value:String):void {
+	  	writeName(name);
+	  	parts.push(value);
+	  	needComma = true;
+	  }
+
+	  private function writeName(name:String):void {
+	  	if (needComma)
+	  		parts.push(",");
+	  	if (name != null)
+	  		parts.push("\"", name, "\":");
+	  }
+
+	  /** Quotes the string, escaping only what JSON requires. */
+	  private static function quote(value:String):String {
+	  	var result:Array = null;
+	  	var runStart:int = 0;
+	  	for (var i:int = 0; i < value.length; i++) {
+	  		var c:int = value.charCodeAt(i);
+	  		if (c >= 0x20 && c != 0x22 && c != 0x5C)
+	  			continue;
+	  		if (result == null)
+	  			result = new Array();
+	  		result.push(value.substring(runStart, i));
+	  		switch (c) {
+	  			case 0x22: result.push("\\\""); break;
+	  			case 0x5C: result.push("\\\\"); break;
+	  			case 0x0A: result.push("\\n"); break;
+	  			case 0x0D: result.push("\\r"); break;
+	  			case 0x09: result.push("\\t"); break;
+	  			case 0x08: result.push("\\b"); break;
+	  			case 0x0C: result.push("\\f"); break;
+	  			default:
+	  				var hex:String = c.toString(16);
+	  				result.push("\\u0000".substring(0, 6 - hex.length) + hex);
+	  		}
+	  		runStart = i + 1;
+	  	}
+	  	if (result == null)
+	  		return "\"" + value + "\"";
+	  	result.push(value.substring(runStart));
+	  	return "\"" + result.join("") + "\"";
+	  }
+	}
+}
@@ -16,10 +16,10 @@
 
 package com.google.protobuf
 {
+	import flash.errors.IllegalOperationError;
 	import flash.utils.ByteArray;
 	import flash.utils.IDataInput;
 	import flash.utils.IDataOutput;
-	import flash.utils.getDefinitionByName;
 	
 	/**
 	 * This would be better if it were abstract, then we could create
@@ -31,65 +31,150 @@ package com.google.protobuf
 	public class Message {
 	
 	  protected var fieldDescriptors:Array;
+	  // The same descriptors by field number, shared by the class
+	  private var descriptorsByNumber:Array;
+
+	  // The values of the fields of CODE_SIZE messages, by FieldTable slot.
+	  // Their generated accessors and the table codecs share it.
+	  protected var fieldValues:Array;
+
+	  // The set extensions, sorted by field number, and their values by
+	  // field number. Both null until an extension is set.
+	  private var extensionList:Vector.<ExtensionDescriptor>;
+	  private var extensionValues:Array;
+
+	  // Set on default instances, see freeze()
+	  private var frozen:Boolean = false;
 	  
-	  //Intialize our field descriptors
+	  //Intialize our field descriptors, registered once per class
 	  public function Message() {
-	  	if (fieldDescriptors == null)
-		  	fieldDescriptors = new Array();	
+	  	var messageType:Class = Object(this).constructor as Class;
+	  	var registered:Boolean = MessageRegistry.getDescriptors(messageType) != null;
+	  	if (!registered)
+	  		MessageRegistry.register(messageType);
+	  	fieldDescriptors = MessageRegistry.getDescriptors(messageType);
+	  	descriptorsByNumber = MessageRegistry.getDescriptorsByNumber(messageType);
+	  	if (!registered)
+	  		registerFields();
 	  }
 	  
-	  public function writeToCodedStream(output:CodedOutputStream ):void {
+	  /**
+	  * Writes the message to the stream. When a mask is given only the
+	  * fields it selects are written.
+	  */
+	  public function writeToCodedStream(output:CodedOutputStream, mask:FieldMask = null):void {
 	  	
-        for each (var desc:Descriptor in fieldDescriptors) 
-        {
-		
-        	//Don't write it if it is null
-			if (this[desc.fieldName] == null)
-			{  
-				if( desc.isRequired())
-					trace("Missing required field " + desc.fieldName);
-			}
-			else
-			{	
-				//We have an array, write it out
-				if (desc.isRepeated() && this[desc.fieldName] is Array)
-				{
-					for each( var elem:* in this[desc.fieldName])
-					{
-						//If its a message, recurse this function, else just write out the primative
-						if (desc.isMessage())
-						{
-							//write out the size first
-//							output.writeRawVarint32(elem.getSerializedSize())
-//							elem.writeToCodedStream(output);
-							output.writeMessage(desc.fieldNumber, elem);
-						}
-						else //primative
-							output.writeField(desc.fieldNumber, elem, desc.type);
-					}
-				}
-				else 
-				{
-					//Message/primative thats not repeated
-					if (desc.isMessage())
-					{
-						if ( this[desc.fieldName] is Message )
-							output.writeMessage(desc.fieldNumber, this[desc.fieldName]);
-					}
-					else //primative
-						output.writeField(desc.fieldNumber, this[desc.fieldName], desc.type);
-				}
-			}
-        }
-      }
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null && mask == null) {
+	  		table.writeTo(this, fieldValues, output);
+	  		return;
+	  	}
+	  	
+	  	for each (var desc:Descriptor in fieldDescriptors) {
+	  		var subMask:FieldMask = null;
+	  		if (mask != null) {
+	  			if (!mask.includes(desc))
+	  				continue;
+	  			subMask = mask.getSubMask(desc);
+	  		}
+
+	  		//Same presence rules and encodings as the table driven codecs,
+	  		//getSerializedSize() relies on it
+	  		var value:* = this[desc.fieldName];
+	  		var tag:int = WireFormat.makeTag(desc.fieldNumber, WireFormat.getWireTypeForFieldType(desc.type));
+	  		if (desc.isRepeated()) {
+	  			for each (var elem:* in value)
+	  				writeReflectedValue(output, desc, tag, elem, subMask);
+	  		} else if (value != null && !(desc.type == Descriptor.ENUM && value == -1)) {
+	  			writeReflectedValue(output, desc, tag, value, subMask);
+	  		}
+	  	}
+
+	  	//Masks select fields by name, extensions only go with whole messages
+	  	if (mask == null)
+	  		writeExtensions(output, 0, int.MAX_VALUE);
+	  }
+
+	  private static function writeReflectedValue(output:CodedOutputStream, desc:Descriptor, tag:int, value:*, mask:FieldMask):void {
+	  	output.writeRawVarint32(tag);
+	  	if (desc.type == Descriptor.MESSAGE) {
+	  		output.writeMessageNoTag(value, mask);
+	  	} else if (desc.type == Descriptor.GROUP && mask != null) {
+	  		value.writeToCodedStream(output, mask);
+	  		output.writeRawVarint32(tag + 1);
+	  	} else {
+	  		FieldTable.writeValue(output, tag, desc.type, value);
+	  	}
+	  }
 	
-	  public function writeToDataOutput(output:IDataOutput):void {
+	  public function writeToDataOutput(output:IDataOutput, mask:FieldMask = null):void {
 	    var codedOutput:CodedOutputStream = CodedOutputStream.newInstance(output);
-	    writeToCodedStream(codedOutput);
+	    writeToCodedStream(codedOutput, mask);
+	    codedOutput.flush();
+	  }
+
+	  /** Encodes the message into a new ByteArray of its exact size. */
+	  public function toByteArray():ByteArray {
+	  	var bytes:ByteArray = new ByteArray();
+	  	writeToByteArray(bytes);
+	  	return bytes;
+	  }
+
+	  /**
+	  * Encodes the message into the given ByteArray, replacing its
+	  * content, and rewinds it. The bytes are sized once, up front, so a
+	  * ByteArray reused across messages stops allocating once it is as
+	  * large as the largest of them.
+	  */
+	  public function writeToByteArray(bytes:ByteArray):void {
+	  	var started:Boolean = CodedOutputStream.beginWrite();
+	  	try {
+	  		bytes.position = 0;
+	  		bytes.length = getSerializedSize();
+	  		writeToCodedStream(CodedOutputStream.newInstance(bytes));
+	  	} finally {
+	  		CodedOutputStream.endWrite(started);
+	  	}
+	  	//what was written is the content, whatever the size said
+	  	bytes.length = bytes.position;
+	  	bytes.position = 0;
+	  }
+
+	  /**
+	  * Writes the size of the message as a varint, then the message. A
+	  * ByteArray output is grown once to fit both.
+	  */
+	  public function writeDelimitedTo(output:IDataOutput):void {
+	  	var started:Boolean = CodedOutputStream.beginWrite();
+	  	try {
+	  		var size:int = getSerializedSize();
+	  		var bytes:ByteArray = output as ByteArray;
+	  		if (bytes != null) {
+	  			var end:int = bytes.position + CodedOutputStream.computeRawVarint32Size(size) + size;
+	  			if (bytes.length < end)
+	  				bytes.length = end;
+	  		}
+	  		var codedOutput:CodedOutputStream = CodedOutputStream.newInstance(output);
+	  		codedOutput.writeRawVarint32(size);
+	  		writeToCodedStream(codedOutput);
+	  		codedOutput.flush();
+	  	} finally {
+	  		CodedOutputStream.endWrite(started);
+	  	}
 	  }
 	 
-	  public function readFromCodedStream(input:CodedInputStream):void {
+	  /**
+	  * Reads the message from the stream. When a mask is given the fields
+	  * it does not select are skipped on the wire and left untouched.
+	  */
+	  public function readFromCodedStream(input:CodedInputStream, mask:FieldMask = null):void {
 	
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null && mask == null) {
+	  		table.readFrom(this, fieldValues, input);
+	  		return;
+	  	}
+	  	
 		//Get the first tag
 	  	var tag:int = input.readTag();
 	  	
@@ -100,6 +185,9 @@ package com.google.protobuf
 	  		var fieldNum:int = WireFormat.getTagFieldNumber(tag);
 	  		var desc:Descriptor = getDescriptorByFieldNumber(fieldNum);
 	  		
+	  		if (desc != null && mask != null && !mask.includes(desc))
+	  			desc = null; //Not selected, skip it like an unknown field
+	  		
 	  		if (desc != null)
 	  		{
 	  			//The item can be any type
@@ -108,17 +196,13 @@ package com.google.protobuf
 	  			//If we have a message, recurse this function to read it in
 	  			if (desc.isMessage())
 	  			{
-	  				//Introspect to get message's type, then read it in
-	  				//Inserting the package here is a little ugly......
-	  				var classRef:Class = getDefinitionByName(desc.messageClass) as Class;
-					item = new classRef();
-					
-					//Read whole message to ByteArray (not the best, too slow but easy)
-					var size:int = input.readRawVarint32();
-					var bytes:ByteArray = input.readRawBytes(size);
-			  		//fix bug 1 protobuf-actionscript3
-					bytes.position = 0;
-					item.readFromDataOutput(bytes);
+					item = new desc.messageType();
+					input.readMessage(item, mask == null ? null : mask.getSubMask(desc));
+	  			}
+	  			else if (desc.type == Descriptor.GROUP)
+	  			{
+	  				item = new desc.messageType();
+	  				input.readGroup(fieldNum, item, mask == null ? null : mask.getSubMask(desc));
 	  			}
 	  			//Just a primative type, read it in
 	  			else
@@ -130,22 +214,58 @@ package com.google.protobuf
 				else
 		  			this[desc.fieldName] = item; //just set it (official pb requires merging here, in the case of duplicates)		
 	  		}
-	  		else
-	  			input.skipField(tag); //Throw it away, we don't have that version
+	  		else if (mask == null) {
+	  			//Throw it away unless it is a known extension
+	  			if (!readExtension(input, tag))
+	  				return; //end group tag, readGroup() checks it
+	  		}
+	  		else if (!input.skipField(tag))
+	  			return; //end group tag, readGroup() checks it
 	  			
 	  		//Read the next tag in stream
 	  		tag = input.readTag();	
 	  	}
 	  }
 	
+	  /**
+	  * IExternalizable support, for the classes generated with the
+	  * "externalizable" option: the message travels through AMF as its
+	  * length delimited wire format.
+	  */
+	  public function writeExternal(output:IDataOutput):void {
+	  	writeDelimitedTo(output);
+	  }
+
+	  /** Reads back what writeExternal() wrote. */
+	  public function readExternal(input:IDataInput):void {
+	  	checkMutable();
+	  	var codedInput:CodedInputStream = CodedInputStream.newInstance(input);
+	  	var oldLimit:int = codedInput.pushLimit(codedInput.readRawVarint32());
+	  	readFromCodedStream(codedInput);
+	  	//an end group tag may have stopped the parser early
+	  	codedInput.skipRawBytes(codedInput.getBytesUntilLimit());
+	  	codedInput.popLimit(oldLimit);
+	  }
+
+	  /**
+	  * Decodes the message from input over several frames, spending up to
+	  * budgetMs milliseconds per frame. Listen to the returned decoder for
+	  * its complete or error event.
+	  */
+	  public function decodeAsync(input:IDataInput, budgetMs:int = 5):SlicedDecoder {
+	  	checkMutable();
+	  	return new SlicedDecoder(this, input, budgetMs);
+	  }
+
 	  /** 
 	  * Wrapper for readFromCodedStream, take something coforming to
 	  * the IDataInput interface and construct a coded stream from it
 	  */
-	  public function readFromDataOutput(input:IDataInput):void {
+	  public function readFromDataOutput(input:IDataInput, mask:FieldMask = null):void {
+	  	checkMutable();
 	    var codedInput:CodedInputStream = CodedInputStream.newInstance(input);
 	    
-	    readFromCodedStream(codedInput);
+	    readFromCodedStream(codedInput, mask);
 	  }
 	  
 	  /**
@@ -155,39 +275,379 @@ package com.google.protobuf
 	  */
 	  public function getSerializedSize():int {
 	  	
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null)
+	  		return table.getSerializedSize(this, fieldValues);
+	  	
 	  	var size:int = 0;
+	  	for each (var desc:Descriptor in fieldDescriptors) {
+	  		var value:* = this[desc.fieldName];
+	  		var tagSize:int = CodedOutputStream.computeTagSize(desc.fieldNumber);
+	  		if (desc.isRepeated()) {
+	  			for each (var elem:* in value)
+	  				size += tagSize + FieldTable.computeValueSize(tagSize, desc.type, elem);
+	  		} else if (value != null && !(desc.type == Descriptor.ENUM && value == -1)) {
+	  			size += tagSize + FieldTable.computeValueSize(tagSize, desc.type, value);
+	  		}
+	  	}
 	  	
-	    for each (var desc:Descriptor in fieldDescriptors) 
-	    {
-	    	//Ignore null fields.. cause we won't write them!
-	    	if (this[desc.fieldName] != null)
-				size += CodedOutputStream.computeFieldSize( desc.fieldNumber, this[desc.fieldName]);
-		} 
-		
-		return size;
+	  	return size + getExtensionsSerializedSize();
+	  }
+
+	  /** Prints the message in protocol buffer text format. */
+	  public function toText():String {
+	  	var output:TextWriter = new TextWriter();
+	  	writeText(output);
+	  	return output.toString();
+	  }
+
+	  /** Merges the fields of the given text format into the message. */
+	  public function mergeFromText(text:String):void {
+	  	checkMutable();
+	  	var input:TextTokenizer = new TextTokenizer(text);
+	  	readText(input);
+	  	if (!input.atEnd())
+	  		throw input.parseError("Expected identifier.");
+	  }
+
+	  /**
+	  * Prints the fields of the message. SPEED messages generate it, the
+	  * others print through their FieldTable, or the registered descriptors.
+	  */
+	  public function writeText(output:TextWriter):void {
+
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null) {
+	  		table.writeText(this, fieldValues, output);
+	  		return;
+	  	}
+
+	  	var sorted:Array = new Array();
+	  	for each (var desc:Descriptor in fieldDescriptors)
+	  		sorted.push(desc);
+	  	sorted.sortOn("fieldNumber", Array.NUMERIC);
+
+	  	for each (desc in sorted)
+	  	{
+	  		var value:* = this[desc.fieldName];
+
+	  		//Enums are printed by number, the descriptors do not know the names
+	  		if (desc.isRepeated())
+	  		{
+	  			for each (var elem:* in value)
+	  				output.printValue(desc.textName, desc.type, elem);
+	  		}
+	  		else if (value != null && !(desc.type == Descriptor.ENUM && value == -1))
+	  			output.printValue(desc.textName, desc.type, value);
+	  	}
+	  }
+
+	  /**
+	  * Merges fields read from the tokenizer into the message, up to the
+	  * end of the text or of the enclosing message.
+	  */
+	  public function readText(input:TextTokenizer):void {
+
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null) {
+	  		table.readText(this, input);
+	  		return;
+	  	}
+
+	  	while (!input.atMessageEnd())
+	  	{
+	  		var name:String = input.consumeIdentifier();
+	  		var desc:Descriptor = getDescriptorByTextName(name);
+	  		if (desc == null)
+	  			throw input.parseError("Message has no field named \"" + name + "\".");
+	  		input.consumeField(this, desc.fieldName, desc.type, desc.isRepeated(), desc.messageType);
+	  	}
+	  }
+
+	  /**
+	  * The message as JSON text, see JsonWriter. It is not named toJSON(),
+	  * which JSON.stringify() calls expecting an Object back.
+	  */
+	  public function toJSONString():String {
+	  	var output:JsonWriter = new JsonWriter();
+	  	output.writeMessage(null, this);
+	  	return output.toString();
+	  }
+
+	  /** Merges the fields of the given JSON text into the message. */
+	  public function mergeFromJSON(text:String):void {
+	  	checkMutable();
+	  	fromJSONObject(JSON.parse(text));
+	  }
+
+	  /**
+	  * Writes the fields of the message as the members of a JSON object.
+	  * SPEED messages generate it, the others write through their
+	  * FieldTable, or the registered descriptors.
+	  */
+	  public function writeJSON(output:JsonWriter):void {
+
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null) {
+	  		table.writeJSON(this, fieldValues, output);
+	  		return;
+	  	}
+
+	  	var sorted:Array = new Array();
+	  	for each (var desc:Descriptor in fieldDescriptors)
+	  		sorted.push(desc);
+	  	sorted.sortOn("fieldNumber", Array.NUMERIC);
+
+	  	for each (desc in sorted)
+	  	{
+	  		var value:* = this[desc.fieldName];
+
+	  		//Enums are written by number, the descriptors do not know the names
+	  		if (desc.isRepeated())
+	  		{
+	  			if (value == null || value.length == 0)
+	  				continue;
+	  			output.beginArray(desc.jsonName);
+	  			for each (var elem:* in value)
+	  				output.writeValue(null, desc.type, elem);
+	  			output.endArray();
+	  		}
+	  		else if (value != null && !(desc.type == Descriptor.ENUM && value == -1))
+	  			output.writeValue(desc.jsonName, desc.type, value);
+	  	}
+	  }
+
+	  /**
+	  * Merges the members of an Object built by JSON.parse() into the
+	  * message. Members may use the JSON or the .proto name of the fields.
+	  */
+	  public function fromJSONObject(object:Object):void {
+
+	  	var table:FieldTable = getFieldTable();
+	  	if (table != null) {
+	  		table.readJSON(this, object);
+	  		return;
+	  	}
+
+	  	for (var name:String in object)
+	  	{
+	  		var desc:Descriptor = getDescriptorByJsonName(name);
+	  		if (desc == null)
+	  			throw new InvalidProtocolBufferException("Message has no field named \"" + name + "\".");
+	  		JsonReader.readField(this, desc.fieldName, desc.type, desc.isRepeated(), desc.messageType, object[name]);
+	  	}
+	  }
+
+	  /**
+	  * Sets the value of an extension of this message, an Array for
+	  * repeated extensions. null clears it.
+	  */
+	  public function setExtension(extension:ExtensionDescriptor, value:*):void {
+	  	checkMutable();
+	  	if (!(this is extension.containingType))
+	  		throw new ArgumentError("\"" + extension.fieldName + "\" does not extend " + extension.containingType + ".");
+	  	if (value == null) {
+	  		clearExtension(extension);
+	  		return;
+	  	}
+	  	if (extensionValues == null) {
+	  		extensionList = new Vector.<ExtensionDescriptor>();
+	  		extensionValues = new Array();
+	  	}
+	  	if (extensionValues[extension.fieldNumber] === undefined) {
+	  		//keep the list sorted, there are usually a few extensions at most
+	  		var i:int = extensionList.length;
+	  		while (i > 0 && extensionList[i - 1].fieldNumber > extension.fieldNumber)
+	  			i--;
+	  		extensionList.splice(i, 0, extension);
+	  	}
+	  	extensionValues[extension.fieldNumber] = value;
+	  }
+
+	  /**
+	  * The value of an extension of this message, null if it is not set.
+	  * Repeated extensions always have an Array, added to by
+	  * addExtension() or directly.
+	  */
+	  public function getExtension(extension:ExtensionDescriptor):* {
+	  	var value:* = extensionValues == null ? undefined : extensionValues[extension.fieldNumber];
+	  	if (value === undefined) {
+	  		if (!extension.isRepeated())
+	  			return null;
+	  		value = new Array();
+	  		if (frozen)
+	  			return value;
+	  		setExtension(extension, value);
+	  	}
+	  	return value;
+	  }
+
+	  /** Appends a value to a repeated extension. */
+	  public function addExtension(extension:ExtensionDescriptor, value:*):void {
+	  	getExtension(extension).push(value);
+	  }
+
+	  public function hasExtension(extension:ExtensionDescriptor):Boolean {
+	  	var value:* = extensionValues == null ? undefined : extensionValues[extension.fieldNumber];
+	  	if (extension.isRepeated())
+	  		return value !== undefined && value.length > 0;
+	  	return value !== undefined;
+	  }
+
+	  public function clearExtension(extension:ExtensionDescriptor):void {
+	  	checkMutable();
+	  	if (extensionValues == null || extensionValues[extension.fieldNumber] === undefined)
+	  		return;
+	  	delete extensionValues[extension.fieldNumber];
+	  	extensionList.splice(extensionList.indexOf(extension), 1);
+	  }
+
+	  /**
+	  * Writes the set extensions numbered from start up to end excluded.
+	  * Called by the codecs between the fields around each extension
+	  * range, so that everything goes out in field number order.
+	  */
+	  public function writeExtensions(output:CodedOutputStream, start:int, end:int):void {
+	  	if (extensionList == null)
+	  		return;
+	  	for each (var extension:ExtensionDescriptor in extensionList) {
+	  		if (extension.fieldNumber < start)
+	  			continue;
+	  		if (extension.fieldNumber >= end)
+	  			return;
+	  		var value:* = extensionValues[extension.fieldNumber];
+	  		if (extension.isRepeated()) {
+	  			for each (var elem:* in value) {
+	  				output.writeRawVarint32(extension.tag);
+	  				FieldTable.writeValue(output, extension.tag, extension.type, elem);
+	  			}
+	  		} else {
+	  			output.writeRawVarint32(extension.tag);
+	  			FieldTable.writeValue(output, extension.tag, extension.type, value);
+	  		}
+	  	}
+	  }
+
+	  /** The number of bytes writeExtensions() writes for all extensions. */
+	  public function getExtensionsSerializedSize():int {
+	  	if (extensionList == null)
+	  		return 0;
+	  	var size:int = 0;
+	  	for each (var extension:ExtensionDescriptor in extensionList) {
+	  		var tagSize:int = CodedOutputStream.computeRawVarint32Size(extension.tag);
+	  		var value:* = extensionValues[extension.fieldNumber];
+	  		if (extension.isRepeated()) {
+	  			for each (var elem:* in value)
+	  				size += tagSize + FieldTable.computeValueSize(tagSize, extension.type, elem);
+	  		} else {
+	  			size += tagSize + FieldTable.computeValueSize(tagSize, extension.type, value);
+	  		}
+	  	}
+	  	return size;
+	  }
+
+	  /**
+	  * Called by the parsers with a tag which is not one of the fields:
+	  * reads the extension it belongs to if the registry of the stream
+	  * knows it, else skips it. Returns false on an end group tag.
+	  */
+	  public function readExtension(input:CodedInputStream, tag:int):Boolean {
+	  	var extension:ExtensionDescriptor = null;
+	  	if (input.extensionRegistry != null)
+	  		extension = input.extensionRegistry.find(Object(this).constructor, WireFormat.getTagFieldNumber(tag));
+	  	if (extension == null || extension.tag != tag)
+	  		return input.skipField(tag);
+
+	  	var value:*;
+	  	if (extension.type == Descriptor.MESSAGE || extension.type == Descriptor.GROUP) {
+	  		//merge a message seen twice
+	  		value = extension.isRepeated() ? null : getExtension(extension);
+	  		if (value == null)
+	  			value = new extension.messageType();
+	  		if (extension.type == Descriptor.MESSAGE)
+	  			input.readMessage(value);
+	  		else
+	  			input.readGroup(extension.fieldNumber, value);
+	  	} else {
+	  		value = input.readPrimitiveField(extension.type);
+	  	}
+	  	if (extension.isRepeated())
+	  		addExtension(extension, value);
+	  	else
+	  		setExtension(extension, value);
+	  	return true;
+	  }
+
+	  /**
+	  * Messages generated for CODE_SIZE files return the table describing
+	  * their fields, the codecs above then use it instead of the
+	  * registered descriptors. Masks still go through the descriptors.
+	  */
+	  protected function getFieldTable():FieldTable {
+	  	return null;
+	  }
+	  
+	  /**
+	  * Called once per class, with the first instance. Subclasses
+	  * override it to register their fields with registerField(), which
+	  * may also be called later on.
+	  */
+	  protected function registerFields():void {
 	  }
 	  
 	  /**
 	  * All subclasses must register the fields they want visible to
 	  * protocol buffers. The protoc executable will take care of
-	  * registering fields for you.
+	  * registering fields for you. messageType is the class of
+	  * message fields, null for the others. textName is the name of the
+	  * field in the .proto file, see Descriptor.textName.
+	  *
+	  * Fields are registered for the whole class, and looked up by name,
+	  * text format name, JSON name and number from then on, whether they
+	  * are registered by registerFields() or later.
 	  */
-	  protected function registerField(field:String, messageClass:String, type:int, label:int, fieldNumber:int):void {
+	  protected function registerField(field:String, messageType:Class, type:int, label:int, fieldNumber:int, textName:String = null):void {
 
 		//register descriptors only once	  	
 	  	if (fieldDescriptors[field] == null)
-		  	fieldDescriptors[field] = new Descriptor(field, messageClass, type, label, fieldNumber);
+	  		MessageRegistry.registerField(Object(this).constructor,
+	  			new Descriptor(field, messageType, type, label, fieldNumber, textName));
 	  }
 	  
+	  /**
+	  * Makes the message read only, which the generated classes do to
+	  * their default instance. The mutable accessors of message fields and
+	  * the parsers then replace a frozen message by a new one instead of
+	  * changing it; the generated setters and the runtime methods changing
+	  * it throw. The Arrays of its repeated fields must not be changed.
+	  */
+	  protected final function freeze():void {
+	  	frozen = true;
+	  }
+
+	  /** Whether freeze() was called, that is for default instances. */
+	  public final function get isFrozen():Boolean {
+	  	return frozen;
+	  }
+
+	  /** Throws when the message is frozen, see freeze(). */
+	  protected final function checkMutable():void {
+	  	if (frozen)
+	  		throw new IllegalOperationError("Default instances are read only.");
+	  }
+
+	  /** Whether the class registered its fields, LITE messages do not. */
+	  internal function get hasDescriptors():Boolean {
+	  	for (var field:String in fieldDescriptors)
+	  		return true;
+	  	return false;
+	  }
+
 	  /**
 	  * Convenience method for getting a descriptor by field number
 	  */
 	  public function getDescriptorByFieldNumber(fieldNum:int):Descriptor {
-	  	for each ( var desc:Descriptor in fieldDescriptors ) {
-	  		if (desc.fieldNumber == fieldNum)
-	  			return desc;
-	  	}
-	  	return null;
+	  	return descriptorsByNumber[fieldNum] as Descriptor;
 	  }
 	  
 	  /**
@@ -196,7 +656,17 @@ package com.google.protobuf
 	  * is just a more descriptive way of indexing the array.
 	  */
 	  public function getDescriptor(field:String):Descriptor {
-		 	return fieldDescriptors[field];
+		 	return fieldDescriptors[field] as Descriptor;
+	  }
+
+	  /** The descriptor of the field named textName in the .proto file. */
+	  public function getDescriptorByTextName(textName:String):Descriptor {
+	  	return MessageRegistry.getDescriptorByTextName(Object(this).constructor, textName);
+	  }
+
+	  /** The descriptor of the field with the given JSON or .proto name. */
+	  public function getDescriptorByJsonName(jsonName:String):Descriptor {
+	  	return MessageRegistry.getDescriptorByJsonName(Object(this).constructor, jsonName);
 	  }
 	  
 	  // =================================================================
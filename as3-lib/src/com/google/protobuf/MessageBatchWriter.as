@@ -0,0 +1,135 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.display.Shape;
+	import flash.events.Event;
+	import flash.net.Socket;
+	import flash.utils.ByteArray;
+	import flash.utils.IDataOutput;
+
+	/**
+	 * Coalesces many small length delimited messages into one write. Each
+	 * message is encoded by a CodedOutputStream into a scratch buffer,
+	 * whose length is its size prefix, then copied behind the prefix into
+	 * a buffer kept from one batch to the next. The buffers are handed to the
+	 * output, and flushed if it is a Socket, once per frame or as soon as
+	 * flushThreshold bytes are pending.
+	 *
+	 * Messages of a higher priority are written before the lower ones of
+	 * the same batch, in order within a priority.
+	 */
+	public final class MessageBatchWriter {
+
+	  public static const DEFAULT_FLUSH_THRESHOLD:int = 16 * 1024;
+
+	  // Any display object gets ENTER_FRAME, even off the display list
+	  private static const ticker:Shape = new Shape();
+
+	  private var output:IDataOutput;
+	  private var flushThreshold:int;
+	  private var flushEachFrame:Boolean;
+
+	  // One buffer per priority, highest priority first
+	  private var priorities:Vector.<int> = new Vector.<int>();
+	  private var buffers:Vector.<ByteArray> = new Vector.<ByteArray>();
+	  private var streams:Vector.<CodedOutputStream> = new Vector.<CodedOutputStream>();
+
+	  private var pending:int = 0;
+
+	  // Where each message is encoded first, to learn its size
+	  private var scratch:ByteArray = new ByteArray();
+	  private var scratchStream:CodedOutputStream = CodedOutputStream.newInstance(scratch);
+
+	  public function MessageBatchWriter(output:IDataOutput,
+	                                     flushThreshold:int = DEFAULT_FLUSH_THRESHOLD,
+	                                     flushEachFrame:Boolean = true) {
+	  	this.output = output;
+	  	this.flushThreshold = flushThreshold;
+	  	this.flushEachFrame = flushEachFrame;
+	  	if (flushEachFrame)
+	  		ticker.addEventListener(Event.ENTER_FRAME, onEnterFrame);
+	  }
+
+	  /** Queues the message, preceded by its size. */
+	  public function write(message:Message, priority:int = 0):void {
+	  	var index:int = batchIndex(priority);
+	  	var buffer:ByteArray = buffers[index];
+	  	var start:int = buffer.position;
+	  	var stream:CodedOutputStream = streams[index];
+	  	scratch.position = 0;
+	  	message.writeToCodedStream(scratchStream);
+	  	scratchStream.flush();
+	  	var size:int = scratch.position;
+	  	stream.writeRawVarint32(size);
+	  	stream.writeRawBytesPartial(scratch, 0, size);
+	  	stream.flush();
+	  	pending += buffer.position - start;
+	  	if (pending >= flushThreshold)
+	  		flush();
+	  }
+
+	  /** The number of bytes queued and not written yet. */
+	  public function get pendingBytes():int {
+	  	return pending;
+	  }
+
+	  /** Writes out everything queued. */
+	  public function flush():void {
+	  	if (pending == 0)
+	  		return;
+	  	for each (var buffer:ByteArray in buffers) {
+	  		if (buffer.position == 0)
+	  			continue;
+	  		output.writeBytes(buffer, 0, buffer.position);
+	  		buffer.position = 0;
+	  	}
+	  	pending = 0;
+	  	var socket:Socket = output as Socket;
+	  	if (socket != null)
+	  		socket.flush();
+	  }
+
+	  /** Writes out what is queued and stops flushing each frame. */
+	  public function dispose():void {
+	  	flush();
+	  	if (flushEachFrame)
+	  		ticker.removeEventListener(Event.ENTER_FRAME, onEnterFrame);
+	  }
+
+	  private function onEnterFrame(event:Event):void {
+	  	flush();
+	  }
+
+	  /**
+	   * The index of the buffer of the priority, added when new. Only the
+	   * buffers are reused, their length does not reflect what is queued.
+	   */
+	  private function batchIndex(priority:int):int {
+	  	var index:int = 0;
+	  	while (index < priorities.length && priorities[index] > priority)
+	  		index++;
+	  	if (index < priorities.length && priorities[index] == priority)
+	  		return index;
+	  	var buffer:ByteArray = new ByteArray();
+	  	priorities.splice(index, 0, priority);
+	  	buffers.splice(index, 0, buffer);
+	  	streams.splice(index, 0, CodedOutputStream.newInstance(buffer));
+	  	return index;
+	  }
+	}
+}
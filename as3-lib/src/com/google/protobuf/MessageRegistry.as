@@ -0,0 +1,100 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.utils.Dictionary;
+
+	/**
+	 * Holds the field descriptors of every message class, registered once
+	 * when the first instance of the class is built and then shared by all
+	 * its instances.
+	 */
+	public final class MessageRegistry {
+
+	  // message Class -> associative array of Descriptors, by field name
+	  private static var descriptors:Dictionary = new Dictionary();
+	  // message Class -> Object of the same Descriptors, by text format name
+	  private static var descriptorsByTextName:Dictionary = new Dictionary();
+	  // message Class -> Object of the same Descriptors, by JSON and .proto name
+	  private static var descriptorsByJsonName:Dictionary = new Dictionary();
+	  // message Class -> sparse Array of the same Descriptors, by field number
+	  private static var descriptorsByNumber:Dictionary = new Dictionary();
+
+	  /**
+	   * The descriptors of the given message class, or null if no instance
+	   * of it was built yet.
+	   */
+	  public static function getDescriptors(messageType:Class):Array {
+	  	return descriptors[messageType];
+	  }
+
+	  /**
+	   * Called by Message with the first instance of a class, before it
+	   * registers its fields with registerField().
+	   */
+	  public static function register(messageType:Class):void {
+	  	descriptors[messageType] = new Array();
+	  	descriptorsByTextName[messageType] = new Object();
+	  	descriptorsByJsonName[messageType] = new Object();
+	  	descriptorsByNumber[messageType] = new Array();
+	  }
+
+	  /**
+	   * Adds the descriptor of a field to a registered message class and to
+	   * its indexes, see Message.registerField(). Fields registered after
+	   * the first instance was built, e.g. by the constructor of a hand
+	   * written message, are indexed as well.
+	   */
+	  public static function registerField(messageType:Class, desc:Descriptor):void {
+	  	descriptors[messageType][desc.fieldName] = desc;
+	  	descriptorsByTextName[messageType][desc.textName] = desc;
+	  	descriptorsByJsonName[messageType][desc.jsonName] = desc;
+	  	descriptorsByJsonName[messageType][desc.protoName] = desc;
+	  	descriptorsByNumber[messageType][desc.fieldNumber] = desc;
+	  }
+
+	  /**
+	   * The descriptors of a registered message class indexed by field
+	   * number, the holes being undefined.
+	   */
+	  public static function getDescriptorsByNumber(messageType:Class):Array {
+	  	return descriptorsByNumber[messageType];
+	  }
+
+	  /**
+	   * The descriptor of the field of a registered message class with the
+	   * given text format name, null if there is none.
+	   */
+	  public static function getDescriptorByTextName(messageType:Class, textName:String):Descriptor {
+	  	var byTextName:Object = descriptorsByTextName[messageType];
+	  	if (byTextName == null || !byTextName.hasOwnProperty(textName))
+	  		return null;
+	  	return byTextName[textName];
+	  }
+
+	  /**
+	   * The descriptor of the field of a registered message class with the
+	   * given JSON or .proto name, null if there is none.
+	   */
+	  public static function getDescriptorByJsonName(messageType:Class, jsonName:String):Descriptor {
+	  	var byJsonName:Object = descriptorsByJsonName[messageType];
+	  	if (byJsonName == null || !byJsonName.hasOwnProperty(jsonName))
+	  		return null;
+	  	return byJsonName[jsonName];
+	  }
+	}
+}
@@ -0,0 +1,30 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	/** A call of a SocketRpcChannel waiting for its response. */
+	internal final class PendingCall {
+
+	  public var responseType:Class;
+	  public var done:Function;
+
+	  public function PendingCall(responseType:Class, done:Function) {
+	  	this.responseType = responseType;
+	  	this.done = done;
+	  }
+	}
+}
@@ -0,0 +1,31 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	/**
+	 * Carries the calls of generated service stubs. A call names its
+	 * method by full name, "package.Service.Method", and is answered by
+	 * calling done(response:Message, error:Error) with either a
+	 * responseType instance or what made the call fail.
+	 *
+	 * Calls must not wait for the previous ones to be answered, and may be
+	 * answered in any order.
+	 */
+	public interface RpcChannel {
+	  function callMethod(method:String, request:Message, responseType:Class, done:Function):void;
+	}
+}
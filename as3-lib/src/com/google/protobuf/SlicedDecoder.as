@@ -0,0 +1,216 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.display.Shape;
+	import flash.events.ErrorEvent;
+	import flash.events.Event;
+	import flash.events.EventDispatcher;
+	import flash.utils.IDataInput;
+	import flash.utils.getTimer;
+
+	/**
+	 * Dispatched once the message is decoded.
+	 * @eventType flash.events.Event.COMPLETE
+	 */
+	[Event(name="complete", type="flash.events.Event")]
+
+	/**
+	 * Dispatched when decoding fails, see error.
+	 * @eventType flash.events.ErrorEvent.ERROR
+	 */
+	[Event(name="error", type="flash.events.ErrorEvent")]
+
+	/**
+	 * Decodes a message a few milliseconds per frame, see
+	 * Message.decodeAsync(). Fields are read one at a time through the
+	 * registered descriptors, and the partially built messages are kept on
+	 * an explicit stack instead of the call stack, so decoding can stop
+	 * after any field and resume on the next ENTER_FRAME.
+	 *
+	 * Embedded messages up to INLINE_SIZE bytes, groups and the messages of
+	 * LITE files, which have no descriptors, are decoded in one go by
+	 * their own readFromCodedStream(). So is a LITE message given to
+	 * decode, on the first step.
+	 */
+	public final class SlicedDecoder extends EventDispatcher {
+
+	  /** Embedded messages this small are not worth slicing. */
+	  public static const INLINE_SIZE:int = 4096;
+
+	  // getTimer() is only checked every so many fields
+	  private static const CHECK_INTERVAL:int = 32;
+
+	  // Any display object gets ENTER_FRAME, even off the display list
+	  private static const ticker:Shape = new Shape();
+
+	  private var input:CodedInputStream;
+	  private var budgetMs:int;
+	  private var decoded:Message;
+	  private var failure:Error;
+	  private var finished:Boolean = false;
+
+	  // The messages being read, innermost last, and the limits to
+	  // restore when each of them ends
+	  private var messages:Array = new Array();
+	  private var oldLimits:Vector.<int> = new Vector.<int>();
+
+	  /**
+	   * Starts decoding input into message on the next frame. A budgetMs
+	   * of 0 leaves the pace to step().
+	   */
+	  public function SlicedDecoder(message:Message, input:IDataInput, budgetMs:int) {
+	  	this.input = CodedInputStream.newInstance(input);
+	  	this.budgetMs = budgetMs;
+	  	this.decoded = message;
+	  	messages.push(message);
+	  	if (budgetMs > 0)
+	  		ticker.addEventListener(Event.ENTER_FRAME, onEnterFrame);
+	  }
+
+	  /** The message being decoded, complete once isComplete. */
+	  public function get message():Message {
+	  	return decoded;
+	  }
+
+	  /** Whether decoding finished, successfully or not. */
+	  public function get isComplete():Boolean {
+	  	return finished;
+	  }
+
+	  /** What stopped decoding, or null. */
+	  public function get error():Error {
+	  	return failure;
+	  }
+
+	  /**
+	   * Decodes fields for up to budgetMs milliseconds. Returns whether
+	   * decoding finished. No events are dispatched for steps called
+	   * directly.
+	   */
+	  public function step(budgetMs:int):Boolean {
+	  	if (finished)
+	  		return true;
+	  	var deadline:int = getTimer() + budgetMs;
+	  	var count:int = 0;
+	  	try {
+	  		while (messages.length > 0) {
+	  			if (++count == CHECK_INTERVAL) {
+	  				count = 0;
+	  				if (getTimer() >= deadline)
+	  					return false;
+	  			}
+	  			readField();
+	  		}
+	  	} catch (e:Error) {
+	  		failure = e;
+	  	}
+	  	finished = true;
+	  	return true;
+	  }
+
+	  /** Stops decoding, no event is dispatched. */
+	  public function cancel():void {
+	  	ticker.removeEventListener(Event.ENTER_FRAME, onEnterFrame);
+	  	finished = true;
+	  }
+
+	  private function onEnterFrame(event:Event):void {
+	  	if (!step(budgetMs))
+	  		return;
+	  	ticker.removeEventListener(Event.ENTER_FRAME, onEnterFrame);
+	  	if (failure != null)
+	  		dispatchEvent(new ErrorEvent(ErrorEvent.ERROR, false, false, failure.message));
+	  	else
+	  		dispatchEvent(new Event(Event.COMPLETE));
+	  }
+
+	  /** Reads one field of the innermost message, or ends it. */
+	  private function readField():void {
+	  	var message:Message = messages[messages.length - 1];
+	  	if (!message.hasDescriptors) {
+	  		//only the root gets here without descriptors, a LITE message
+	  		message.readFromCodedStream(input);
+	  		input.checkLastTagWas(0);
+	  		messages.pop();
+	  		return;
+	  	}
+	  	var tag:int = input.readTag();
+	  	if (tag == 0) {
+	  		endMessage();
+	  		return;
+	  	}
+
+	  	var fieldNumber:int = WireFormat.getTagFieldNumber(tag);
+	  	var desc:Descriptor = message.getDescriptorByFieldNumber(fieldNumber);
+	  	if (desc == null) {
+	  		//groups are read by readGroup(), so no end group tag belongs
+	  		//to a message on the stack
+	  		if (!message.readExtension(input, tag))
+	  			throw InvalidProtocolBufferException.invalidEndTag();
+	  		return;
+	  	}
+	  	if (!desc.isMessage() && desc.type != Descriptor.GROUP) {
+	  		if (desc.isRepeated())
+	  			message[desc.fieldName].push(input.readPrimitiveField(desc.type));
+	  		else
+	  			message[desc.fieldName] = input.readPrimitiveField(desc.type);
+	  		return;
+	  	}
+
+	  	//merge a message field seen twice
+	  	var item:Message = desc.isRepeated() ? null : message[desc.fieldName];
+	  	if (item == null || item.isFrozen) {
+	  		item = new desc.messageType();
+	  		if (desc.isRepeated())
+	  			message[desc.fieldName].push(item);
+	  		else
+	  			message[desc.fieldName] = item;
+	  	}
+	  	if (desc.type == Descriptor.GROUP) {
+	  		input.readGroup(fieldNumber, item);
+	  		return;
+	  	}
+
+	  	var length:int = input.readRawVarint32();
+	  	var oldLimit:int = input.pushLimit(length);
+	  	if (length > INLINE_SIZE && item.hasDescriptors) {
+	  		messages.push(item);
+	  		oldLimits.push(oldLimit);
+	  		return;
+	  	}
+	  	item.readFromCodedStream(input);
+	  	checkMessageEnd();
+	  	input.popLimit(oldLimit);
+	  }
+
+	  /** Pops the innermost message, which read up to its limit. */
+	  private function endMessage():void {
+	  	messages.pop();
+	  	if (messages.length == 0)
+	  		return;
+	  	checkMessageEnd();
+	  	input.popLimit(oldLimits.pop());
+	  }
+
+	  private function checkMessageEnd():void {
+	  	input.checkLastTagWas(0);
+	  	if (input.getBytesUntilLimit() != 0)
+	  		throw InvalidProtocolBufferException.truncatedMessage();
+	  }
+	}
+}
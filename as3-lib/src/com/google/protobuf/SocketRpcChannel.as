@@ -0,0 +1,210 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import flash.errors.IOError;
+	import flash.events.Event;
+	import flash.events.IOErrorEvent;
+	import flash.events.ProgressEvent;
+	import flash.events.SecurityErrorEvent;
+	import flash.net.Socket;
+	import flash.utils.ByteArray;
+
+	/**
+	 * An RpcChannel over one Socket, pipelining the calls: each request is
+	 * sent right away, tagged with a call id, and the responses are
+	 * matched back by that id in whatever order the server sends them.
+	 *
+	 * Both ways, every call is a varint length followed by an envelope
+	 * message with these fields:
+	 *
+	 *   1: uint32 id       the call id, chosen by the client
+	 *   2: string method   the full method name, requests only
+	 *   3: bytes payload   the encoded request or response
+	 *   4: string error    set by the server instead of the payload
+	 */
+	public class SocketRpcChannel implements RpcChannel {
+
+	  private static const ID_TAG:int = WireFormat.makeTag(1, WireFormat.WIRETYPE_VARINT);
+	  private static const PAYLOAD_TAG:int = WireFormat.makeTag(3, WireFormat.WIRETYPE_LENGTH_DELIMITED);
+	  private static const ERROR_TAG:int = WireFormat.makeTag(4, WireFormat.WIRETYPE_LENGTH_DELIMITED);
+
+	  // Compact the received bytes once this many are consumed
+	  private static const COMPACT_SIZE:int = 64 * 1024;
+
+	  private var socket:Socket;
+	  private var nextId:int = 1;
+
+	  // Set by close() and when the socket closes or fails
+	  private var closed:Boolean = false;
+
+	  // Calls waiting for their response, by id
+	  private var pending:Object = new Object();
+
+	  // Bytes received but not parsed yet, from readPos
+	  private var received:ByteArray = new ByteArray();
+	  private var readPos:int = 0;
+
+	  /**
+	   * Calls made while the socket is not connected, or once the channel
+	   * is closed, fail right away.
+	   */
+	  public function SocketRpcChannel(socket:Socket) {
+	  	this.socket = socket;
+	  	socket.addEventListener(ProgressEvent.SOCKET_DATA, onData);
+	  	socket.addEventListener(Event.CLOSE, onClose);
+	  	socket.addEventListener(IOErrorEvent.IO_ERROR, onClose);
+	  	socket.addEventListener(SecurityErrorEvent.SECURITY_ERROR, onClose);
+	  }
+
+	  public function callMethod(method:String, request:Message, responseType:Class, done:Function):void {
+	  	if (closed || !socket.connected) {
+	  		done(null, new IOError(closed ? "RPC channel closed." : "RPC channel not connected."));
+	  		return;
+	  	}
+	  	var id:int = nextId++;
+	  	var envelope:ByteArray = new ByteArray();
+	  	var output:CodedOutputStream = CodedOutputStream.newInstance(envelope);
+	  	output.writeUInt32(1, id);
+	  	output.writeString(2, method);
+	  	output.writeMessage(3, request);
+	  	output.flush();
+
+	  	pending[id] = new PendingCall(responseType, done);
+	  	var frame:CodedOutputStream = CodedOutputStream.newInstance(socket);
+	  	frame.writeRawVarint32(envelope.length);
+	  	frame.writeRawBytes(envelope);
+	  	frame.flush();
+	  	socket.flush();
+	  }
+
+	  /** Closes the socket, the calls not answered yet fail. */
+	  public function close():void {
+	  	if (socket.connected)
+	  		socket.close();
+	  	failAll(new IOError("RPC channel closed."));
+	  }
+
+	  /**
+	   * Answers the calls of every complete frame received. A malformed
+	   * frame leaves the stream out of sync, so the channel is closed and
+	   * the calls not answered yet fail.
+	   */
+	  private function onData(event:ProgressEvent):void {
+	  	if (closed)
+	  		return;
+	  	socket.readBytes(received, received.length);
+	  	var frameLength:int;
+	  	try {
+	  		while ((frameLength = nextFrame()) >= 0) {
+	  			var end:int = received.position + frameLength;
+	  			readEnvelope(end);
+	  			readPos = end;
+	  		}
+	  	} catch (e:InvalidProtocolBufferException) {
+	  		received.length = 0;
+	  		readPos = 0;
+	  		if (socket.connected)
+	  			socket.close();
+	  		failAll(e);
+	  		return;
+	  	}
+	  	if (readPos == received.length) {
+	  		received.length = 0;
+	  		readPos = 0;
+	  	} else if (readPos >= COMPACT_SIZE) {
+	  		var rest:ByteArray = new ByteArray();
+	  		rest.writeBytes(received, readPos);
+	  		received = rest;
+	  		readPos = 0;
+	  	}
+	  }
+
+	  /**
+	   * Positions received after the length of the next frame and returns
+	   * that length, or -1 when the frame is not complete yet.
+	   */
+	  private function nextFrame():int {
+	  	var length:int = 0;
+	  	var pos:int = readPos;
+	  	for (var shift:int = 0; shift < 32; shift += 7) {
+	  		if (pos >= received.length)
+	  			return -1;
+	  		var b:int = received[pos++];
+	  		length |= (b & 0x7F) << shift;
+	  		if (b < 0x80) {
+	  			if (received.length - pos < length)
+	  				return -1;
+	  			received.position = pos;
+	  			return length;
+	  		}
+	  	}
+	  	throw InvalidProtocolBufferException.malformedVarint();
+	  }
+
+	  /** Answers the call the envelope ending at end is for. */
+	  private function readEnvelope(end:int):void {
+	  	var input:CodedInputStream = CodedInputStream.newInstance(received);
+	  	input.pushLimit(end - received.position);
+	  	var id:int = 0;
+	  	var payload:ByteArray = null;
+	  	var error:String = null;
+	  	var tag:int;
+	  	while ((tag = input.readTag()) != 0) {
+	  		if (tag == ID_TAG)
+	  			id = input.readUInt32();
+	  		else if (tag == PAYLOAD_TAG)
+	  			payload = input.readBytes();
+	  		else if (tag == ERROR_TAG)
+	  			error = input.readString();
+	  		else
+	  			input.skipField(tag);
+	  	}
+
+	  	var call:PendingCall = pending[id];
+	  	if (call == null)
+	  		return; //not ours, or already failed
+	  	delete pending[id];
+	  	if (error != null) {
+	  		call.done(null, new Error(error));
+	  		return;
+	  	}
+	  	var response:Message;
+	  	try {
+	  		response = new call.responseType();
+	  		if (payload != null)
+	  			response.readFromDataOutput(payload);
+	  	} catch (e:Error) {
+	  		call.done(null, e);
+	  		return;
+	  	}
+	  	call.done(response, null);
+	  }
+
+	  private function onClose(event:Event):void {
+	  	failAll(new IOError("RPC channel closed: " + event.type + "."));
+	  }
+
+	  private function failAll(error:Error):void {
+	  	closed = true;
+	  	var calls:Object = pending;
+	  	pending = new Object();
+	  	for each (var call:PendingCall in calls)
+	  		call.done(null, error);
+	  }
+	}
+}
@@ -1,96 +1,100 @@
 package com.google.protobuf
 {
-	import flash.utils.getDefinitionByName;
-	
-	
+	import com.hurlant.math.BigInteger;
+	import flash.utils.Dictionary;
+	import flash.utils.getQualifiedClassName;
+
 	/**
-	 * A limited set of the original java implementation. To Be Completed
-	 * 
-	 * @author Philippe Pascal 
+	 * Entry points of the text format, which the messages implement with
+	 * TextWriter and TextTokenizer, see Message.toText() and
+	 * Message.mergeFromText().
+	 *
+	 * @author Philippe Pascal
 	 */
 	public class TextFormat
 	{
 		public static const underscorePattern:RegExp = /_([a-z])/g;
-		public const fieldPattern:RegExp = /(\w(\w|[-\.])*):\s(.+)$/gm;
-		public const messagePattern:RegExp = /(\w(\w|[-\.])*)\s\{([^\}]+)\}/g; //gms
-		
+		public static const capitalPattern:RegExp = /([A-Z])/g;
+
+		private static const TWO_63:BigInteger = BigInteger.ONE.shiftLeft(63);
+		private static const TWO_64:BigInteger = BigInteger.ONE.shiftLeft(64);
+		private static const BILLION:BigInteger = BigInteger.nbv(1000000000);
+
+		// value names Object -> the reverse Object, value numbers by name
+		private static const valueNumbers:Dictionary = new Dictionary(true);
+
 		public function TextFormat()
 		{
 		}
 
+		/** Merges the fields of the text into the message. */
 		public function merge(gpbMessage:Message,text:String):void {
-			//trace("### merge "+gpbMessage);
-			var matchedMessages:Array = new Array();
-			var matchedFields:Array = new Array();
-			//1 match the messages.
-			var matchMessage:Array = messagePattern.exec(text);
-			while(matchMessage != null) {
-				matchedMessages.push(matchMessage);
-				matchMessage = messagePattern.exec(text);
-			}
-			for each(var matchedMessage:Array in matchedMessages) {
-				var fieldName:String = morphGPBNameToMessageName(matchedMessage[1]);
-				//trace("message: "+matchedMessage[1]+" ,fieldName: "+fieldName+" ,value: "+matchedMessage[3]);
-				var descriptor:Descriptor = gpbMessage.getDescriptor(fieldName);
-				var classRef:Class = getDefinitionByName(descriptor.messageClass) as Class;
-				var embeddedMessage:Message = new classRef() as Message;
-				merge(embeddedMessage,matchedMessage[3]);
-				(gpbMessage[fieldName] as Array).push(embeddedMessage);
-			}
-			//2 remove the messages from the text
-			messagePattern.lastIndex=0;
-			var textWOMessage:String = text.replace(messagePattern,"");
-			//3 match the fields
-			var matchField:Array = fieldPattern.exec(textWOMessage);
-			while(matchField != null) {
-				matchedFields.push(matchField);
-				matchField = fieldPattern.exec(textWOMessage);
-			}
-			for each(var matchedField:Array in matchedFields) {
-				fieldName = morphGPBNameToMessageName(matchedField[1]);
-				//trace("field: "+matchedField[1]+" ,fieldName: "+fieldName+" ,value: "+matchedField[3]);
-				descriptor = gpbMessage.getDescriptor(fieldName);
-				gpbMessage[fieldName] = parseValue(descriptor.type,matchedField[3]);
-			}
-			//
-			//trace("### done merging "+gpbMessage);
+			gpbMessage.mergeFromText(text);
 		}
-		
-		public function parseValue(type:int,value:String):Object {
-			switch(type) {
-//		      case Descriptor.DOUBLE  : return readDouble  ();
-//		      case Descriptor.FLOAT   : return readFloat   ();
-//		      case Descriptor.INT64   : return readInt64   ();
-//		      case Descriptor.UINT64  : return readUInt64  ();
-//		      case Descriptor.INT32   : return readInt32   ();
-//		      case Descriptor.FIXED64 : return readFixed64 ();
-//		      case Descriptor.FIXED32 : return readFixed32 ();
-		      case Descriptor.BOOL    : return readBool    (value);
-		      case Descriptor.STRING  : return readString  (value);
-//		      case Descriptor.BYTES   : return readBytes   ();
-//		      case Descriptor.UINT32  : return readUInt32  ();
-//		      case Descriptor.SFIXED32: return readSFixed32();
-//		      case Descriptor.SFIXED64: return readSFixed64();
-//		      case Descriptor.SINT32  : return readSInt32  ();
-//		      case Descriptor.SINT64  : return readSInt64  ();
-			  case Descriptor.ENUM    : return readEnum    (value);
-			  default: return null;
-			}
+
+		/** Prints the message in text format. */
+		public static function printToString(gpbMessage:Message):String {
+			return gpbMessage.toText();
 		}
-		public function readBool(value:String):Boolean {
-			return value.indexOf("true")==0;
+
+		/**
+		 * Decimal form of an int64, sint64 or sfixed64 value. The runtime
+		 * keeps negative int64 in two's complement, as read from the wire.
+		 */
+		public static function int64ToString(value:BigInteger):String {
+			if (value.compareTo(TWO_63) >= 0)
+				value = value.subtract(TWO_64);
+			return uint64ToString(value);
 		}
-		public function readString(value:String):String {
-			return value.substring(1,value.length-1);
+
+		/** Decimal form of a uint64 or fixed64 value. */
+		public static function uint64ToString(value:BigInteger):String {
+			if (value.signum() < 0)
+				return "-" + uint64ToString(value.negate());
+			// nine digits at a time
+			var result:String = "";
+			while (value.compareTo(BILLION) >= 0) {
+				var digits:String = String(value.remainder(BILLION).intValue());
+				result = "000000000".substring(digits.length) + digits + result;
+				value = value.divide(BILLION);
+			}
+			return String(value.intValue()) + result;
 		}
-		//PLACEHOLDER -- TODO
-		public function readEnum(value:String):int {
-			return 1;
+
+		/**
+		 * The numbers of the values of an enum by name, from the value names
+		 * generated for its fields, which map the numbers to the names. Built
+		 * once per value names Object.
+		 */
+		public static function enumValueNumbers(names:Object):Object {
+			var numbers:Object = valueNumbers[names];
+			if (numbers == null) {
+				numbers = new Object();
+				for (var number:String in names)
+					numbers[names[number]] = int(number);
+				valueNumbers[names] = numbers;
+			}
+			return numbers;
+		}
+
+		/**
+		 * The name of a field in text format, guessed from the property
+		 * holding it for the hand written messages which do not register
+		 * it, see Descriptor.textName. Groups are named after their type.
+		 * The guess is wrong for names whose camel case form is ambiguous,
+		 * such as foo_1bar.
+		 */
+		public static function textFieldName(fieldName:String, type:int, messageType:Object):String {
+			if (type == Descriptor.GROUP) {
+				var className:String = getQualifiedClassName(messageType);
+				return className.substring(className.lastIndexOf(":") + 1);
+			}
+			return morphMessageNameToGPBName(fieldName);
 		}
-		
+
 		/**
 		 * for some reasone (GPB or existing AS code), field names are transformed between
-		 * the proto files and the actionscript class message. This needs to be consistent 
+		 * the proto files and the actionscript class message. This needs to be consistent
 		 * text format.
 		 */
 		public static function morphGPBNameToMessageName(fieldName:String):String {
@@ -101,7 +105,19 @@ package com.google.protobuf
 		                                 index:int,
 		                                 str:String):String
 		{
-		 	return capturedMatch1.toUpperCase();                      	
+		 	return capturedMatch1.toUpperCase();
+		}
+
+		/** The reverse of morphGPBNameToMessageName(). */
+		public static function morphMessageNameToGPBName(fieldName:String):String {
+			return fieldName.replace(capitalPattern,underscore);
+		}
+		public static function underscore(matchedSubstring:String,
+		                                  capturedMatch1:String,
+		                                  index:int,
+		                                  str:String):String
+		{
+			return "_" + capturedMatch1.toLowerCase();
 		}
 	}
-}
\ No newline at end of file
+}
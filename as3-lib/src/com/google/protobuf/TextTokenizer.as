@@ -0,0 +1,517 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import com.hurlant.math.BigInteger;
+	import flash.utils.ByteArray;
+
+	/**
+	 * Reads protocol buffer text format, one token at a time, in a single
+	 * pass over the text. The generated readText() methods, and the
+	 * reflective one of Message, pull the field names and values from it.
+	 *
+	 * Errors are reported as InvalidProtocolBufferException, prefixed with
+	 * the line and column of the offending token.
+	 */
+	public final class TextTokenizer {
+
+	  private static const END:int        = 0;
+	  private static const IDENTIFIER:int = 1;
+	  private static const NUMBER:int     = 2;
+	  private static const STRING:int     = 3;
+	  private static const SYMBOL:int     = 4;
+
+	  private static const TWO_63:BigInteger = BigInteger.ONE.shiftLeft(63);
+	  private static const TWO_64:BigInteger = BigInteger.ONE.shiftLeft(64);
+
+	  private var text:String;
+	  private var length:int;
+	  private var pos:int = 0;
+	  private var line:int = 0;
+	  private var lineStart:int = 0;
+
+	  // The current token, and where it starts
+	  private var tokenType:int;
+	  private var token:String;
+	  private var tokenLine:int;
+	  private var tokenColumn:int;
+
+	  public function TextTokenizer(text:String) {
+	  	this.text = text;
+	  	this.length = text.length;
+	  	nextToken();
+	  }
+
+	  /** True once all the text was consumed. */
+	  public function atEnd():Boolean {
+	  	return tokenType == END;
+	  }
+
+	  /**
+	   * True at the end of the fields of a message: before the closing
+	   * brace of a nested message, or at the end of the text.
+	   */
+	  public function atMessageEnd():Boolean {
+	  	return tokenType == END || token == "}" || token == ">";
+	  }
+
+	  public function lookingAt(symbol:String):Boolean {
+	  	return token == symbol && tokenType != STRING;
+	  }
+
+	  /** Consumes the given symbol or identifier if it is the next token. */
+	  public function tryConsume(symbol:String):Boolean {
+	  	if (lookingAt(symbol)) {
+	  		nextToken();
+	  		return true;
+	  	}
+	  	return false;
+	  }
+
+	  public function consume(symbol:String):void {
+	  	if (!tryConsume(symbol))
+	  		throw parseError("Expected \"" + symbol + "\".");
+	  }
+
+	  public function consumeIdentifier():String {
+	  	if (tokenType != IDENTIFIER)
+	  		throw parseError("Expected identifier.");
+	  	var result:String = token;
+	  	nextToken();
+	  	return result;
+	  }
+
+	  /** int32, sint32 and sfixed32 values. */
+	  public function consumeInt32():int {
+	  	var value:Number = consumeInteger(true);
+	  	if (value < int.MIN_VALUE || value > int.MAX_VALUE)
+	  		throw parseError("Integer out of range.");
+	  	nextToken();
+	  	return int(value);
+	  }
+
+	  /** uint32 and fixed32 values, held in an int like on the wire. */
+	  public function consumeUInt32():int {
+	  	var value:Number = consumeInteger(false);
+	  	if (value > uint.MAX_VALUE)
+	  		throw parseError("Integer out of range.");
+	  	nextToken();
+	  	return int(uint(value));
+	  }
+
+	  /**
+	   * int64 and sfixed64 values. Negative values are returned in two's
+	   * complement, as CodedInputStream reads them.
+	   */
+	  public function consumeInt64():BigInteger {
+	  	var value:BigInteger = consumeSInt64();
+	  	if (value.signum() < 0)
+	  		value = value.add(TWO_64);
+	  	return value;
+	  }
+
+	  /** sint64 values, which the runtime keeps signed. */
+	  public function consumeSInt64():BigInteger {
+	  	var value:BigInteger = consumeBigInteger(true);
+	  	if (value.compareTo(TWO_63) >= 0 || value.compareTo(TWO_63.negate()) < 0)
+	  		throw parseError("Integer out of range.");
+	  	nextToken();
+	  	return value;
+	  }
+
+	  /** uint64 and fixed64 values. */
+	  public function consumeUInt64():BigInteger {
+	  	var value:BigInteger = consumeBigInteger(false);
+	  	if (value.compareTo(TWO_64) >= 0)
+	  		throw parseError("Integer out of range.");
+	  	nextToken();
+	  	return value;
+	  }
+
+	  /** double and float values, "inf" and "nan" included. */
+	  public function consumeDouble():Number {
+	  	if (tokenType != NUMBER && tokenType != IDENTIFIER)
+	  		throw parseError("Expected number.");
+	  	var s:String = token.toLowerCase();
+	  	var negative:Boolean = s.charAt(0) == "-";
+	  	if (negative)
+	  		s = s.substring(1);
+	  	var value:Number;
+	  	if (s == "inf" || s == "infinity") {
+	  		value = Number.POSITIVE_INFINITY;
+	  	} else if (s == "nan") {
+	  		value = Number.NaN;
+	  	} else {
+	  		if (tokenType != NUMBER)
+	  			throw parseError("Expected number.");
+	  		if (s.charAt(s.length - 1) == "f" && s.indexOf("0x") != 0)
+	  			s = s.substring(0, s.length - 1);
+	  		value = Number(s);
+	  		if (isNaN(value))
+	  			throw parseError("Expected number.");
+	  	}
+	  	nextToken();
+	  	return negative ? -value : value;
+	  }
+
+	  public function consumeBool():Boolean {
+	  	var result:Boolean;
+	  	if (token == "true" || token == "t" || token == "1")
+	  		result = true;
+	  	else if (token == "false" || token == "f" || token == "0")
+	  		result = false;
+	  	else
+	  		throw parseError("Expected \"true\" or \"false\".");
+	  	nextToken();
+	  	return result;
+	  }
+
+	  /** A string literal, UTF-8 once unescaped. */
+	  public function consumeString():String {
+	  	var bytes:ByteArray = consumeBytes();
+	  	return bytes.readUTFBytes(bytes.length);
+	  }
+
+	  /**
+	   * A string literal, as bytes. Adjacent literals are concatenated like
+	   * in C.
+	   */
+	  public function consumeBytes():ByteArray {
+	  	if (tokenType != STRING)
+	  		throw parseError("Expected string.");
+	  	var bytes:ByteArray = new ByteArray();
+	  	do {
+	  		unescape(token, bytes);
+	  		nextToken();
+	  	} while (tokenType == STRING);
+	  	bytes.position = 0;
+	  	return bytes;
+	  }
+
+	  /**
+	   * An enum value, by name or by number. names maps the numbers of the
+	   * values to their names, as generated for enum fields.
+	   */
+	  public function consumeEnum(names:Object):int {
+	  	if (tokenType != IDENTIFIER)
+	  		return consumeInt32();
+	  	var numbers:Object = TextFormat.enumValueNumbers(names);
+	  	if (!numbers.hasOwnProperty(token))
+	  		throw parseError("Unknown enumeration value \"" + token + "\".");
+	  	var number:int = numbers[token];
+	  	nextToken();
+	  	return number;
+	  }
+
+	  /**
+	   * Merges a nested message, "{ ... }" or "< ... >", into the given one,
+	   * which is returned. The colon before it is optional.
+	   */
+	  public function consumeMessage(message:Message):Message {
+	  	tryConsume(":");
+	  	var close:String;
+	  	if (tryConsume("<")) {
+	  		close = ">";
+	  	} else {
+	  		consume("{");
+	  		close = "}";
+	  	}
+	  	message.readText(this);
+	  	consume(close);
+	  	return message;
+	  }
+
+	  /**
+	   * Reads the value of a field of the given Descriptor type. names are
+	   * the value names of enum fields, see consumeEnum().
+	   */
+	  public function consumeValue(type:int, names:Object = null):* {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.SINT32:
+	  		case Descriptor.SFIXED32:
+	  			return consumeInt32();
+	  		case Descriptor.UINT32:
+	  		case Descriptor.FIXED32:
+	  			return consumeUInt32();
+	  		case Descriptor.INT64:
+	  		case Descriptor.SFIXED64:
+	  			return consumeInt64();
+	  		case Descriptor.SINT64:
+	  			return consumeSInt64();
+	  		case Descriptor.UINT64:
+	  		case Descriptor.FIXED64:
+	  			return consumeUInt64();
+	  		case Descriptor.FLOAT:
+	  		case Descriptor.DOUBLE:
+	  			return consumeDouble();
+	  		case Descriptor.BOOL:
+	  			return consumeBool();
+	  		case Descriptor.STRING:
+	  			return consumeString();
+	  		case Descriptor.BYTES:
+	  			return consumeBytes();
+	  		case Descriptor.ENUM:
+	  			return consumeEnum(names);
+	  	}
+	  	throw parseError("Unsupported field type " + type + ".");
+	  }
+
+	  /**
+	   * Merges the value of a field into the property of the message holding
+	   * it. messageType is the class of message fields, the value names of
+	   * enum fields. Used by the reflective readers.
+	   */
+	  public function consumeField(message:Message, property:String, type:int,
+	                               repeated:Boolean, messageType:*):void {
+	  	if (type == Descriptor.MESSAGE || type == Descriptor.GROUP) {
+	  		var item:Message;
+	  		if (repeated) {
+	  			item = new messageType();
+	  			message[property].push(item);
+	  		} else {
+	  			item = message[property];
+	  			if (item == null || item.isFrozen) {
+	  				item = new messageType();
+	  				message[property] = item;
+	  			}
+	  		}
+	  		consumeMessage(item);
+	  		return;
+	  	}
+
+	  	consume(":");
+	  	var value:* = consumeValue(type, messageType);
+	  	if (repeated)
+	  		message[property].push(value);
+	  	else
+	  		message[property] = value;
+	  }
+
+	  /** An error about the current token. */
+	  public function parseError(description:String):InvalidProtocolBufferException {
+	  	return new InvalidProtocolBufferException(
+	  		(tokenLine + 1) + ":" + (tokenColumn + 1) + ": " + description);
+	  }
+
+	  // -----------------------------------------------------------------
+
+	  private function nextToken():void {
+	  	skipWhitespace();
+	  	tokenLine = line;
+	  	tokenColumn = pos - lineStart;
+
+	  	if (pos >= length) {
+	  		tokenType = END;
+	  		token = "";
+	  		return;
+	  	}
+
+	  	var start:int = pos;
+	  	var c:int = text.charCodeAt(pos++);
+	  	if (isLetter(c)) {
+	  		while (pos < length && isIdentifierPart(text.charCodeAt(pos)))
+	  			pos++;
+	  		tokenType = IDENTIFIER;
+	  	} else if (isDigit(c) || c == 0x2D /* - */ || c == 0x2E /* . */) {
+	  		while (pos < length && isNumberPart(text.charCodeAt(pos), text.charCodeAt(pos - 1)))
+	  			pos++;
+	  		tokenType = NUMBER;
+	  	} else if (c == 0x22 /* " */ || c == 0x27 /* ' */) {
+	  		var closed:Boolean = false;
+	  		while (pos < length) {
+	  			var d:int = text.charCodeAt(pos++);
+	  			if (d == c) {
+	  				closed = true;
+	  				break;
+	  			}
+	  			if (d == 0x0A)
+	  				break;
+	  			if (d == 0x5C /* \ */)
+	  				pos++;
+	  		}
+	  		if (!closed)
+	  			throw parseError("Unterminated string literal.");
+	  		tokenType = STRING;
+	  	} else {
+	  		tokenType = SYMBOL;
+	  	}
+	  	token = text.substring(start, pos);
+	  }
+
+	  /** Skips whitespace and "#" comments, counting the lines. */
+	  private function skipWhitespace():void {
+	  	while (pos < length) {
+	  		var c:int = text.charCodeAt(pos);
+	  		if (c == 0x0A) {
+	  			line++;
+	  			lineStart = ++pos;
+	  		} else if (c == 0x20 || c == 0x09 || c == 0x0D || c == 0x0B || c == 0x0C) {
+	  			pos++;
+	  		} else if (c == 0x23 /* # */) {
+	  			while (pos < length && text.charCodeAt(pos) != 0x0A)
+	  				pos++;
+	  		} else {
+	  			return;
+	  		}
+	  	}
+	  }
+
+	  private static function isLetter(c:int):Boolean {
+	  	return (c >= 0x61 && c <= 0x7A) || (c >= 0x41 && c <= 0x5A) || c == 0x5F;
+	  }
+
+	  private static function isDigit(c:int):Boolean {
+	  	return c >= 0x30 && c <= 0x39;
+	  }
+
+	  private static function isIdentifierPart(c:int):Boolean {
+	  	return isLetter(c) || isDigit(c);
+	  }
+
+	  /** Exponents may carry a sign, e.g. "1e-5". */
+	  private static function isNumberPart(c:int, previous:int):Boolean {
+	  	if (isIdentifierPart(c) || c == 0x2E)
+	  		return true;
+	  	return (c == 0x2B || c == 0x2D) && (previous == 0x65 || previous == 0x45);
+	  }
+
+	  private static function digitValue(c:int):int {
+	  	if (c >= 0x30 && c <= 0x39) return c - 0x30;
+	  	if (c >= 0x61 && c <= 0x66) return c - 0x61 + 10;
+	  	if (c >= 0x41 && c <= 0x46) return c - 0x41 + 10;
+	  	return -1;
+	  }
+
+	  // Where the digits of the current integer token start, its radix and
+	  // sign, set by scanInteger().
+	  private var digitsStart:int;
+	  private var radix:int;
+	  private var negative:Boolean;
+
+	  /** Checks the current token is an integer: decimal, 0x hex or 0 octal. */
+	  private function scanInteger(signed:Boolean):void {
+	  	if (tokenType != NUMBER)
+	  		throw parseError("Expected integer.");
+	  	var i:int = 0;
+	  	negative = token.charCodeAt(0) == 0x2D;
+	  	if (negative) {
+	  		if (!signed)
+	  			throw parseError("Expected unsigned integer.");
+	  		i++;
+	  	}
+	  	radix = 10;
+	  	if (token.charCodeAt(i) == 0x30 && token.length > i + 1) {
+	  		if ((token.charCodeAt(i + 1) | 0x20) == 0x78 /* x */) {
+	  			radix = 16;
+	  			i += 2;
+	  		} else {
+	  			radix = 8;
+	  			i++;
+	  		}
+	  	}
+	  	digitsStart = i;
+	  	if (i == token.length)
+	  		throw parseError("Expected integer.");
+	  	for (; i < token.length; i++) {
+	  		var digit:int = digitValue(token.charCodeAt(i));
+	  		if (digit < 0 || digit >= radix)
+	  			throw parseError("Expected integer.");
+	  	}
+	  }
+
+	  /** The current integer token, exact for anything 32 bits. */
+	  private function consumeInteger(signed:Boolean):Number {
+	  	scanInteger(signed);
+	  	var value:Number = 0;
+	  	for (var i:int = digitsStart; i < token.length; i++)
+	  		value = value * radix + digitValue(token.charCodeAt(i));
+	  	return negative ? -value : value;
+	  }
+
+	  private function consumeBigInteger(signed:Boolean):BigInteger {
+	  	scanInteger(signed);
+	  	var value:BigInteger = BigInteger.nbv(0);
+	  	var base:BigInteger = BigInteger.nbv(radix);
+	  	for (var i:int = digitsStart; i < token.length; i++)
+	  		value = value.multiply(base).add(BigInteger.nbv(digitValue(token.charCodeAt(i))));
+	  	return negative ? value.negate() : value;
+	  }
+
+	  /**
+	   * Appends the bytes of a quoted string token to the array, C escapes
+	   * resolved. Unescaped characters are written as UTF-8.
+	   */
+	  private function unescape(literal:String, bytes:ByteArray):void {
+	  	var end:int = literal.length - 1;
+	  	var runStart:int = 1;
+	  	var i:int = 1;
+	  	while (i < end) {
+	  		if (literal.charCodeAt(i) != 0x5C) {
+	  			i++;
+	  			continue;
+	  		}
+	  		if (runStart < i)
+	  			bytes.writeUTFBytes(literal.substring(runStart, i));
+
+	  		var c:int = literal.charCodeAt(++i);
+	  		i++;
+	  		switch (c) {
+	  			case 0x61: bytes.writeByte(0x07); break; // \a
+	  			case 0x62: bytes.writeByte(0x08); break; // \b
+	  			case 0x66: bytes.writeByte(0x0C); break; // \f
+	  			case 0x6E: bytes.writeByte(0x0A); break; // \n
+	  			case 0x72: bytes.writeByte(0x0D); break; // \r
+	  			case 0x74: bytes.writeByte(0x09); break; // \t
+	  			case 0x76: bytes.writeByte(0x0B); break; // \v
+	  			case 0x78: // \x, one or two hex digits
+	  			case 0x58: {
+	  				var hex:int = 0;
+	  				var count:int = 0;
+	  				while (count < 2 && i < end && digitValue(literal.charCodeAt(i)) >= 0) {
+	  					hex = hex * 16 + digitValue(literal.charCodeAt(i++));
+	  					count++;
+	  				}
+	  				if (count == 0)
+	  					throw parseError("Expected hex digits for escape sequence.");
+	  				bytes.writeByte(hex);
+	  				break;
+	  			}
+	  			default:
+	  				if (c >= 0x30 && c <= 0x37) { // octal, up to three digits
+	  					var octal:int = c - 0x30;
+	  					for (count = 1; count < 3 && i < end; count++) {
+	  						var o:int = literal.charCodeAt(i);
+	  						if (o < 0x30 || o > 0x37)
+	  							break;
+	  						octal = octal * 8 + o - 0x30;
+	  						i++;
+	  					}
+	  					bytes.writeByte(octal);
+	  				} else if (c == 0x5C || c == 0x3F || c == 0x27 || c == 0x22) {
+	  					bytes.writeByte(c);
+	  				} else {
+	  					throw parseError("Invalid escape sequence in string literal.");
+	  				}
+	  		}
+	  		runStart = i;
+	  	}
+	  	if (runStart < end)
+	  		bytes.writeUTFBytes(literal.substring(runStart, end));
+	  }
+	}
+}
@@ -0,0 +1,188 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf
+{
+	import com.hurlant.math.BigInteger;
+	import flash.utils.ByteArray;
+
+	/**
+	 * Prints messages in protocol buffer text format, one field per line.
+	 * The generated writeText() methods, and the reflective one of Message,
+	 * print their fields to it. The pieces are only joined by toString().
+	 */
+	public final class TextWriter {
+
+	  private var parts:Array = new Array();
+	  private var indent:String = "";
+
+	  /** Prints a field whose value is already formatted. */
+	  public function printField(name:String, value:String):void {
+	  	parts.push(indent, name, ": ", value, "\n");
+	  }
+
+	  public function printInt32(name:String, value:int):void {
+	  	printField(name, String(value));
+	  }
+
+	  /** uint32 and fixed32 values, held in an int. */
+	  public function printUInt32(name:String, value:int):void {
+	  	printField(name, String(uint(value)));
+	  }
+
+	  /** int64 and sfixed64 values, which the runtime keeps unsigned. */
+	  public function printInt64(name:String, value:BigInteger):void {
+	  	printField(name, TextFormat.int64ToString(value));
+	  }
+
+	  public function printSInt64(name:String, value:BigInteger):void {
+	  	printInt64(name, value);
+	  }
+
+	  public function printUInt64(name:String, value:BigInteger):void {
+	  	printField(name, TextFormat.uint64ToString(value));
+	  }
+
+	  public function printDouble(name:String, value:Number):void {
+	  	if (isNaN(value))
+	  		printField(name, "nan");
+	  	else if (value == Number.POSITIVE_INFINITY)
+	  		printField(name, "inf");
+	  	else if (value == Number.NEGATIVE_INFINITY)
+	  		printField(name, "-inf");
+	  	else
+	  		printField(name, String(value));
+	  }
+
+	  public function printBool(name:String, value:Boolean):void {
+	  	printField(name, value ? "true" : "false");
+	  }
+
+	  public function printString(name:String, value:String):void {
+	  	printField(name, "\"" + escapeString(value) + "\"");
+	  }
+
+	  public function printBytes(name:String, value:ByteArray):void {
+	  	printField(name, "\"" + escapeBytes(value) + "\"");
+	  }
+
+	  /**
+	   * Prints the name of the enum value, or its number when names, as
+	   * generated for enum fields, does not know it.
+	   */
+	  public function printEnum(name:String, value:int, names:Object):void {
+	  	var valueName:String = names == null ? null : names[value];
+	  	printField(name, valueName != null ? valueName : String(value));
+	  }
+
+	  public function printMessage(name:String, message:Message):void {
+	  	parts.push(indent, name, " {\n");
+	  	var outer:String = indent;
+	  	indent += "  ";
+	  	message.writeText(this);
+	  	indent = outer;
+	  	parts.push(indent, "}\n");
+	  }
+
+	  /**
+	   * Prints a value of the given Descriptor type, names being the value
+	   * names of enum fields. Used by the reflective writers.
+	   */
+	  public function printValue(name:String, type:int, value:*, names:Object = null):void {
+	  	switch (type) {
+	  		case Descriptor.INT32:
+	  		case Descriptor.SINT32:
+	  		case Descriptor.SFIXED32:
+	  			printInt32(name, value);
+	  			break;
+	  		case Descriptor.UINT32:
+	  		case Descriptor.FIXED32:
+	  			printUInt32(name, value);
+	  			break;
+	  		case Descriptor.INT64:
+	  		case Descriptor.SINT64:
+	  		case Descriptor.SFIXED64:
+	  			printInt64(name, value);
+	  			break;
+	  		case Descriptor.UINT64:
+	  		case Descriptor.FIXED64:
+	  			printUInt64(name, value);
+	  			break;
+	  		case Descriptor.FLOAT:
+	  		case Descriptor.DOUBLE:
+	  			printDouble(name, value);
+	  			break;
+	  		case Descriptor.BOOL:
+	  			printBool(name, value);
+	  			break;
+	  		case Descriptor.STRING:
+	  			printString(name, value);
+	  			break;
+	  		case Descriptor.BYTES:
+	  			printBytes(name, value);
+	  			break;
+	  		case Descriptor.ENUM:
+	  			printEnum(name, value, names);
+	  			break;
+	  		case Descriptor.MESSAGE:
+	  		case Descriptor.GROUP:
+	  			printMessage(name, value);
+	  			break;
+	  	}
+	  }
+
+	  public function toString():String {
+	  	return parts.join("");
+	  }
+
+	  // -----------------------------------------------------------------
+
+	  /** Strings of printable ASCII are printed as they are. */
+	  private static function escapeString(value:String):String {
+	  	for (var i:int = 0; i < value.length; i++) {
+	  		var c:int = value.charCodeAt(i);
+	  		if (c < 0x20 || c >= 0x7F || c == 0x22 || c == 0x27 || c == 0x5C) {
+	  			var bytes:ByteArray = new ByteArray();
+	  			bytes.writeUTFBytes(value);
+	  			return escapeBytes(bytes);
+	  		}
+	  	}
+	  	return value;
+	  }
+
+	  /** C escapes, octal for the bytes which are not printable ASCII. */
+	  private static function escapeBytes(bytes:ByteArray):String {
+	  	var result:Array = new Array();
+	  	for (var i:int = 0; i < bytes.length; i++) {
+	  		var b:int = bytes[i];
+	  		switch (b) {
+	  			case 0x0A: result.push("\\n"); break;
+	  			case 0x0D: result.push("\\r"); break;
+	  			case 0x09: result.push("\\t"); break;
+	  			case 0x22: result.push("\\\""); break;
+	  			case 0x27: result.push("\\\'"); break;
+	  			case 0x5C: result.push("\\\\"); break;
+	  			default:
+	  				if (b >= 0x20 && b < 0x7F)
+	  					result.push(String.fromCharCode(b));
+	  				else
+	  					result.push("\\" + (b >> 6) + ((b >> 3) & 7) + (b & 7));
+	  		}
+	  	}
+	  	return result.join("");
+	  }
+	}
+}
@@ -54,6 +54,27 @@ package com.google.protobuf
 	  public static function makeTag(fieldNumber:int, wireType:int):int {
 	    return (fieldNumber << TAG_TYPE_BITS) | wireType;
 	  }
+
+	  /** The wire type of the fields of the given Descriptor type. */
+	  public static function getWireTypeForFieldType(type:int):int {
+	    switch (type) {
+	      case Descriptor.DOUBLE:
+	      case Descriptor.FIXED64:
+	      case Descriptor.SFIXED64:
+	        return WIRETYPE_FIXED64;
+	      case Descriptor.FLOAT:
+	      case Descriptor.FIXED32:
+	      case Descriptor.SFIXED32:
+	        return WIRETYPE_FIXED32;
+	      case Descriptor.STRING:
+	      case Descriptor.BYTES:
+	      case Descriptor.MESSAGE:
+	        return WIRETYPE_LENGTH_DELIMITED;
+	      case Descriptor.GROUP:
+	        return WIRETYPE_START_GROUP;
+	    }
+	    return WIRETYPE_VARINT;
+	  }
 	
 	  // Field numbers for fields in MessageSet wire format.
 	  public static const MESSAGE_SET_ITEM:int    = 1;
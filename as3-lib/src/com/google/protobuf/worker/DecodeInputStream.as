@@ -0,0 +1,45 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.google.protobuf.CodedInputStream;
+	import com.hurlant.math.BigInteger;
+	import flash.utils.IDataInput;
+
+	/**
+	 * The stream of DecodeWorker: 64 bits values are read as
+	 * ExternalizableBigInteger, so they survive the way back through AMF.
+	 */
+	internal final class DecodeInputStream extends CodedInputStream {
+
+	  public function DecodeInputStream(input:IDataInput) {
+	  	super(input);
+	  }
+
+	  override public function readRawVarint64():BigInteger {
+	  	return new ExternalizableBigInteger(super.readRawVarint64());
+	  }
+
+	  override public function readRawLittleEndian64():BigInteger {
+	  	return new ExternalizableBigInteger(super.readRawLittleEndian64());
+	  }
+
+	  override public function readSInt64():BigInteger {
+	  	return new ExternalizableBigInteger(super.readSInt64());
+	  }
+	}
+}
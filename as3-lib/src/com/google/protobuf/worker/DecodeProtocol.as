@@ -0,0 +1,72 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.google.protobuf.Descriptor;
+	import com.google.protobuf.MessageRegistry;
+	import flash.net.registerClassAlias;
+	import flash.utils.Dictionary;
+	import flash.utils.getQualifiedClassName;
+
+	/**
+	 * What WorkerDecoder and DecodeWorker agree on: the names of the
+	 * shared properties, and the message types both know by their index.
+	 */
+	internal final class DecodeProtocol {
+
+	  /** The shareable ByteArray of the FrameRing of encoded messages. */
+	  public static const RING:String = "protobuf.ring";
+	  /**
+	   * The shareable ByteArray of the FrameRing of results, each the AMF
+	   * encoding of a decoded message or of the text of an error.
+	   */
+	  public static const RESULT_RING:String = "protobuf.resultRing";
+	  /** Main to worker channel, signalling frames were written. */
+	  public static const REQUESTS:String = "protobuf.requests";
+	  /**
+	   * Worker to main channel, one value per result in order: true when
+	   * it is in the result ring, else a ByteArray holding it.
+	   */
+	  public static const RESULTS:String = "protobuf.results";
+
+	  /**
+	   * Registers the classes under their qualified names, so messages keep
+	   * their class through AMF: the given message classes, the classes of
+	   * their message fields, recursively, and ExternalizableBigInteger.
+	   * LITE_RUNTIME messages do not describe their fields, the classes of
+	   * theirs must be given too.
+	   */
+	  public static function registerTypes(types:Array):void {
+	  	registerClassAlias(getQualifiedClassName(ExternalizableBigInteger), ExternalizableBigInteger);
+	  	var registered:Dictionary = new Dictionary();
+	  	for each (var type:Class in types)
+	  		registerType(type, registered);
+	  }
+
+	  private static function registerType(type:Class, registered:Dictionary):void {
+	  	if (registered[type])
+	  		return;
+	  	registered[type] = true;
+	  	registerClassAlias(getQualifiedClassName(type), type);
+	  	new type(); //registers the descriptors of its fields
+	  	for each (var desc:Descriptor in MessageRegistry.getDescriptors(type)) {
+	  		if (desc.messageType != null)
+	  			registerType(desc.messageType, registered);
+	  	}
+	  }
+	}
+}
@@ -0,0 +1,99 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.google.protobuf.CodedInputStream;
+	import com.google.protobuf.Message;
+	import flash.events.Event;
+	import flash.system.MessageChannel;
+	import flash.system.Worker;
+	import flash.utils.ByteArray;
+
+	/**
+	 * The background side of WorkerDecoder. The document class of the
+	 * worker SWF creates one, with the same types, in the same order, as
+	 * given to the WorkerDecoder:
+	 *
+	 *   public class DecoderMain extends Sprite {
+	 *     private var worker:DecodeWorker = new DecodeWorker([Foo, Bar]);
+	 *   }
+	 *
+	 * Every frame is decoded with a CodedInputStream straight from the
+	 * shared ring. The message is written back in AMF to the result ring,
+	 * and only a signal goes through the results channel: the main worker
+	 * reads the message in place rather than through a copy made by the
+	 * channel.
+	 */
+	public final class DecodeWorker {
+
+	  private var types:Array;
+	  private var ring:FrameRing;
+	  private var resultRing:FrameRing;
+	  private var requests:MessageChannel;
+	  private var results:MessageChannel;
+	  // The AMF of the last result, reused
+	  private var result:ByteArray = new ByteArray();
+
+	  public function DecodeWorker(types:Array) {
+	  	var current:Worker = Worker.current;
+	  	if (current.isPrimordial)
+	  		throw new Error("DecodeWorker runs in the worker created by WorkerDecoder.");
+	  	this.types = types;
+	  	DecodeProtocol.registerTypes(types);
+	  	ring = new FrameRing(current.getSharedProperty(DecodeProtocol.RING));
+	  	resultRing = new FrameRing(current.getSharedProperty(DecodeProtocol.RESULT_RING));
+	  	requests = current.getSharedProperty(DecodeProtocol.REQUESTS);
+	  	results = current.getSharedProperty(DecodeProtocol.RESULTS);
+	  	requests.addEventListener(Event.CHANNEL_MESSAGE, onRequest);
+	  	//frames may have been written before the listener was there
+	  	decodeFrames();
+	  }
+
+	  private function onRequest(event:Event):void {
+	  	while (requests.messageAvailable)
+	  		requests.receive();
+	  	decodeFrames();
+	  }
+
+	  /**
+	   * Decodes every frame in the ring, errors are sent as their text. A
+	   * result which does not fit in the result ring goes through the
+	   * channel instead.
+	   */
+	  private function decodeFrames():void {
+	  	var length:int;
+	  	while ((length = ring.next()) >= 0) {
+	  		result.clear();
+	  		try {
+	  			var message:Message = new types[ring.typeId]();
+	  			var input:CodedInputStream = new DecodeInputStream(ring.bytes);
+	  			input.pushLimit(length);
+	  			message.readFromCodedStream(input);
+	  			result.writeObject(message);
+	  		} catch (e:Error) {
+	  			result.clear();
+	  			result.writeObject(e.message);
+	  		}
+	  		ring.release();
+	  		if (resultRing.write(0, result))
+	  			results.send(true);
+	  		else
+	  			results.send(result); //copied by the channel
+	  	}
+	  }
+	}
+}
@@ -0,0 +1,55 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.hurlant.math.BigInteger;
+	import com.hurlant.math.bi_internal;
+	import flash.utils.IDataInput;
+	import flash.utils.IDataOutput;
+	import flash.utils.IExternalizable;
+
+	use namespace bi_internal;
+
+	/**
+	 * A BigInteger which survives AMF, as the 64 bits values decoded by a
+	 * DecodeWorker are. AMF only writes public properties, and BigInteger
+	 * keeps its sign and chunks in the bi_internal namespace.
+	 */
+	public final class ExternalizableBigInteger extends BigInteger implements IExternalizable {
+
+	  public function ExternalizableBigInteger(value:BigInteger = null) {
+	  	super();
+	  	if (value != null)
+	  		value.copyTo(this);
+	  }
+
+	  public function writeExternal(output:IDataOutput):void {
+	  	output.writeInt(t);
+	  	output.writeInt(s);
+	  	for (var i:int = 0; i < t; i++)
+	  		output.writeInt(a[i]);
+	  }
+
+	  public function readExternal(input:IDataInput):void {
+	  	t = input.readInt();
+	  	s = input.readInt();
+	  	a = new Array();
+	  	for (var i:int = 0; i < t; i++)
+	  		a[i] = input.readInt();
+	  }
+	}
+}
@@ -0,0 +1,149 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import flash.utils.ByteArray;
+	import flash.utils.Endian;
+
+	/**
+	 * A ring of frames in a shareable ByteArray, written by one worker and
+	 * read by another. Each frame is its length, a type id and the encoded
+	 * message, stored contiguously: a frame which does not fit before the
+	 * end of the ring starts over at its beginning.
+	 *
+	 * The header holds the read and write counters, each only advanced by
+	 * its own side through atomicCompareAndSwapIntAt(), which also
+	 * publishes the frame bytes written before. The counters wrap around,
+	 * which is why the capacity is a power of two.
+	 */
+	public final class FrameRing {
+
+	  public static const HEADER_SIZE:int = 8;
+	  public static const FRAME_HEADER_SIZE:int = 8;
+
+	  private static const READ_AT:int = 0;
+	  private static const WRITE_AT:int = 4;
+
+	  private var buffer:ByteArray;
+	  private var capacity:int;
+	  private var mask:int;
+
+	  // The frame returned by next(), see release()
+	  private var frameEnd:int;
+	  private var frameTypeId:int;
+
+	  /** Wraps a ring allocated by allocate(), possibly in another worker. */
+	  public function FrameRing(buffer:ByteArray) {
+	  	this.buffer = buffer;
+	  	buffer.endian = Endian.LITTLE_ENDIAN;
+	  	this.capacity = buffer.length - HEADER_SIZE;
+	  	this.mask = capacity - 1;
+	  }
+
+	  /** capacity is rounded up to a power of two. */
+	  public static function allocate(capacity:int):FrameRing {
+	  	var size:int = 1024;
+	  	while (size < capacity)
+	  		size <<= 1;
+	  	var buffer:ByteArray = new ByteArray();
+	  	buffer.shareable = true;
+	  	buffer.length = HEADER_SIZE + size;
+	  	return new FrameRing(buffer);
+	  }
+
+	  /** The shared bytes, to hand over to the other worker. */
+	  public function get bytes():ByteArray {
+	  	return buffer;
+	  }
+
+	  /**
+	   * Producer side: copies a frame in. Returns false when the ring has
+	   * no room left for it.
+	   */
+	  public function write(typeId:int, frame:ByteArray):Boolean {
+	  	var size:int = FRAME_HEADER_SIZE + frame.length;
+	  	if (size > capacity)
+	  		return false;
+
+	  	var write:int = load(WRITE_AT);
+	  	var read:int = load(READ_AT);
+	  	var offset:int = write & mask;
+	  	var skip:int = offset + size > capacity ? capacity - offset : 0;
+	  	var used:int = write - read; //int wraps like the counters
+	  	if (capacity - used < skip + size)
+	  		return false;
+
+	  	if (skip > 0) {
+	  		//tell the reader the rest of the ring is unused
+	  		if (skip >= 4) {
+	  			buffer.position = HEADER_SIZE + offset;
+	  			buffer.writeInt(-1);
+	  		}
+	  		offset = 0;
+	  	}
+	  	buffer.position = HEADER_SIZE + offset;
+	  	buffer.writeInt(frame.length);
+	  	buffer.writeInt(typeId);
+	  	buffer.writeBytes(frame, 0, frame.length);
+
+	  	buffer.atomicCompareAndSwapIntAt(WRITE_AT, write, write + skip + size);
+	  	return true;
+	  }
+
+	  /**
+	   * Consumer side: positions bytes on the message of the next frame and
+	   * returns its length, or -1 if the ring is empty. The frame stays
+	   * valid until release().
+	   */
+	  public function next():int {
+	  	var read:int = load(READ_AT);
+	  	if (read == load(WRITE_AT))
+	  		return -1;
+
+	  	var offset:int = read & mask;
+	  	var length:int = -1;
+	  	if (capacity - offset >= 4) {
+	  		buffer.position = HEADER_SIZE + offset;
+	  		length = buffer.readInt();
+	  	}
+	  	if (length == -1) {
+	  		read += capacity - offset;
+	  		offset = 0;
+	  		buffer.position = HEADER_SIZE;
+	  		length = buffer.readInt();
+	  	}
+	  	frameTypeId = buffer.readInt();
+	  	frameEnd = read + FRAME_HEADER_SIZE + length;
+	  	return length;
+	  }
+
+	  /** The type id of the frame returned by next(). */
+	  public function get typeId():int {
+	  	return frameTypeId;
+	  }
+
+	  /** Consumer side: gives the space of the current frame back. */
+	  public function release():void {
+	  	buffer.atomicCompareAndSwapIntAt(READ_AT, load(READ_AT), frameEnd);
+	  }
+
+	  /** Reads a counter. Swapping 0 for 0 never changes it. */
+	  private function load(at:int):int {
+	  	return buffer.atomicCompareAndSwapIntAt(at, 0, 0);
+	  }
+	}
+}
@@ -0,0 +1,44 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.google.protobuf.Message;
+
+	/** A WorkerDecoder.decode() waiting for its turn to be called back. */
+	internal final class PendingDecode {
+
+	  public var done:Boolean = false;
+
+	  private var callback:Function;
+	  private var message:Message;
+	  private var error:Error;
+
+	  public function PendingDecode(callback:Function) {
+	  	this.callback = callback;
+	  }
+
+	  public function complete(message:Message, error:Error):void {
+	  	this.message = message;
+	  	this.error = error;
+	  	done = true;
+	  }
+
+	  public function callBack():void {
+	  	callback(message, error);
+	  }
+	}
+}
@@ -0,0 +1,175 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package com.google.protobuf.worker
+{
+	import com.google.protobuf.InvalidProtocolBufferException;
+	import com.google.protobuf.Message;
+	import flash.events.Event;
+	import flash.system.MessageChannel;
+	import flash.system.Worker;
+	import flash.system.WorkerDomain;
+	import flash.utils.ByteArray;
+	import flash.utils.IExternalizable;
+
+	/**
+	 * Decodes messages in a background worker, so large payloads do not
+	 * stall the frame rate. Encoded messages are copied into a FrameRing
+	 * shared with a DecodeWorker, and the decoded messages come back in
+	 * AMF through a second one, which the player reads natively, much
+	 * faster than the protocol buffer decoding done in ActionScript.
+	 *
+	 * types lists the message classes which can be decoded, the worker
+	 * SWF must create its DecodeWorker with the same list. Without a
+	 * worker SWF, where workers are not supported, and for frames which do
+	 * not fit in the ring, messages are decoded synchronously instead. So
+	 * are the messages generated with the externalizable option, whose
+	 * AMF form is their encoding: reading them back would decode them
+	 * again. Callbacks are called in the order of the decode() calls
+	 * either way.
+	 *
+	 * Extensions are not carried back from the worker.
+	 */
+	public final class WorkerDecoder {
+
+	  public static const DEFAULT_RING_CAPACITY:int = 1 << 20;
+
+	  private var typeIds:Array;
+	  // Whether the types, by id, are decoded in the worker
+	  private var decodedInWorker:Array = new Array();
+	  private var worker:Worker;
+	  private var ring:FrameRing;
+	  private var resultRing:FrameRing;
+	  private var requests:MessageChannel;
+	  private var results:MessageChannel;
+
+	  // Every decode() not yet called back, in order
+	  private var queue:Array = new Array();
+	  // The part of it handed to the worker, in order
+	  private var inWorker:Array = new Array();
+
+	  public function WorkerDecoder(workerBytes:ByteArray, types:Array,
+	                                ringCapacity:int = DEFAULT_RING_CAPACITY) {
+	  	typeIds = types.concat();
+	  	if (workerBytes == null || !Worker.isSupported)
+	  		return;
+
+	  	DecodeProtocol.registerTypes(types);
+	  	for each (var type:Class in types)
+	  		decodedInWorker.push(!(new type() is IExternalizable));
+	  	ring = FrameRing.allocate(ringCapacity);
+	  	resultRing = FrameRing.allocate(ringCapacity);
+	  	worker = WorkerDomain.current.createWorker(workerBytes);
+	  	requests = Worker.current.createMessageChannel(worker);
+	  	results = worker.createMessageChannel(Worker.current);
+	  	worker.setSharedProperty(DecodeProtocol.RING, ring.bytes);
+	  	worker.setSharedProperty(DecodeProtocol.RESULT_RING, resultRing.bytes);
+	  	worker.setSharedProperty(DecodeProtocol.REQUESTS, requests);
+	  	worker.setSharedProperty(DecodeProtocol.RESULTS, results);
+	  	results.addEventListener(Event.CHANNEL_MESSAGE, onResult);
+	  	worker.start();
+	  }
+
+	  /** Whether decoding happens in a background worker. */
+	  public function get isAsynchronous():Boolean {
+	  	return worker != null;
+	  }
+
+	  /**
+	   * Decodes bytes, from its position to its end, as a messageType.
+	   * callback is a function(message:Message, error:Error), called with
+	   * the message or with the error which stopped decoding.
+	   */
+	  public function decode(messageType:Class, bytes:ByteArray, callback:Function):void {
+	  	var entry:PendingDecode = new PendingDecode(callback);
+	  	var typeId:int = typeIds.indexOf(messageType);
+	  	if (typeId < 0)
+	  		throw new ArgumentError("Unregistered message type " + messageType + ".");
+
+	  	if (worker != null && decodedInWorker[typeId]) {
+	  		var start:uint = bytes.position;
+	  		var frame:ByteArray = bytes;
+	  		if (start > 0) {
+	  			frame = new ByteArray();
+	  			bytes.readBytes(frame);
+	  		}
+	  		if (ring.write(typeId, frame)) {
+	  			queue.push(entry);
+	  			inWorker.push(entry);
+	  			requests.send(true);
+	  			return;
+	  		}
+	  		//the copy consumed the bytes, decode them from where they were
+	  		bytes.position = start;
+	  	}
+
+	  	//decode right away, but keep the callbacks in order
+	  	try {
+	  		var message:Message = new messageType();
+	  		message.readFromDataOutput(bytes);
+	  		entry.complete(message, null);
+	  	} catch (e:Error) {
+	  		entry.complete(null, e);
+	  	}
+	  	queue.push(entry);
+	  	flush();
+	  }
+
+	  /** Stops the worker, pending callbacks are never called. */
+	  public function dispose():void {
+	  	if (worker != null) {
+	  		results.removeEventListener(Event.CHANNEL_MESSAGE, onResult);
+	  		worker.terminate();
+	  		worker = null;
+	  	}
+	  	queue.length = 0;
+	  	inWorker.length = 0;
+	  }
+
+	  private function onResult(event:Event):void {
+	  	while (results.messageAvailable) {
+	  		var bytes:ByteArray = results.receive() as ByteArray;
+	  		var entry:PendingDecode = inWorker.shift();
+	  		var result:*;
+	  		try {
+	  			if (bytes != null) {
+	  				bytes.position = 0;
+	  				result = bytes.readObject();
+	  			} else {
+	  				resultRing.next();
+	  				result = resultRing.bytes.readObject();
+	  			}
+	  		} catch (e:Error) {
+	  			result = e.message;
+	  		} finally {
+	  			if (bytes == null)
+	  				resultRing.release();
+	  		}
+	  		if (result is Message)
+	  			entry.complete(result, null);
+	  		else
+	  			entry.complete(null, new InvalidProtocolBufferException(String(result)));
+	  	}
+	  	flush();
+	  }
+
+	  /** Calls back the completed decodes at the head of the queue. */
+	  private function flush():void {
+	  	while (queue.length > 0 && PendingDecode(queue[0]).done)
+	  		PendingDecode(queue.shift()).callBack();
+	  }
+	}
+}
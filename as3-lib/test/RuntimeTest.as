@@ -0,0 +1,474 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package
+{
+	import as3.unittest.AllTypes;
+	import as3.unittest.As3Unittest;
+	import as3.unittest.Item;
+	import as3.unittest.Nested;
+	import com.google.protobuf.*;
+	import com.google.protobuf.worker.DecodeWorker;
+	import com.google.protobuf.worker.WorkerDecoder;
+	import flash.display.Sprite;
+	import flash.errors.IllegalOperationError;
+	import flash.events.ProgressEvent;
+	import flash.system.Worker;
+	import flash.utils.ByteArray;
+
+	/**
+	 * Round trip tests of the runtime against the classes generated from
+	 * compiler/as3/testdata/as3_unittest.proto, for the speed and the
+	 * code_size optimize modes; lite classes have no text or JSON support.
+	 * See INSTALL for how to build and run them. Each failure is traced,
+	 * and the last line gives the count.
+	 */
+	public class RuntimeTest extends Sprite {
+
+	  // Enough for SlicedDecoder.step() to decode any of the test messages
+	  private static const STEP_MS:int = 10000;
+
+	  private var failures:int = 0;
+
+	  // Started by the WorkerDecoder tests, in the worker created from this SWF
+	  private var decodeWorker:DecodeWorker;
+
+	  public function RuntimeTest() {
+	  	if (!Worker.current.isPrimordial) {
+	  		decodeWorker = new DecodeWorker([AllTypes]);
+	  		return;
+	  	}
+	  	testGroupRoundTrip();
+	  	testUnknownGroupSkipped();
+	  	testSlicedDecoderRejectsEndGroup();
+	  	testSlicedDecoderReadsGroup();
+	  	testSlicedDecoderLiteRoot();
+	  	testFieldRegisteredLater();
+	  	testJsonNames();
+	  	testJsonRoundTrip();
+	  	testJsonUnknownMember();
+	  	testTextNames();
+	  	testTextRoundTrip();
+	  	testMaskedWrite();
+	  	testMaskedRead();
+	  	testExtensionRoundTrip();
+	  	testDefaultInstance();
+	  	testWorkerDecoderRingFull();
+	  	testSocketRpcChannelMalformedFrame();
+	  	trace(failures == 0 ? "PASS" : "FAIL: " + failures + " failures");
+	  }
+
+	  private function check(condition:Boolean, what:String):void {
+	  	if (!condition) {
+	  		failures++;
+	  		trace("FAILED: " + what);
+	  	}
+	  }
+
+	  /** Calls f and checks it throws an InvalidProtocolBufferException. */
+	  private function checkThrows(f:Function, what:String):void {
+	  	try {
+	  		f();
+	  	} catch (e:InvalidProtocolBufferException) {
+	  		return;
+	  	}
+	  	check(false, what + " should throw");
+	  }
+
+	  private function newAllTypes():AllTypes {
+	  	var message:AllTypes = new AllTypes();
+	  	message.requiredInt32 = 1;
+	  	return message;
+	  }
+
+	  private function parse(bytes:ByteArray):AllTypes {
+	  	bytes.position = 0;
+	  	var message:AllTypes = new AllTypes();
+	  	message.readFromDataOutput(bytes);
+	  	return message;
+	  }
+
+	  /** Field 1 set to 9, after an unknown group of the given number. */
+	  private function withUnknownGroup(fieldNumber:int):ByteArray {
+	  	var bytes:ByteArray = new ByteArray();
+	  	var output:CodedOutputStream = CodedOutputStream.newInstance(bytes);
+	  	output.writeTag(fieldNumber, WireFormat.WIRETYPE_START_GROUP);
+	  	output.writeInt32(1, 5);
+	  	output.writeTag(fieldNumber + 1, WireFormat.WIRETYPE_START_GROUP);
+	  	output.writeTag(fieldNumber + 1, WireFormat.WIRETYPE_END_GROUP);
+	  	output.writeTag(fieldNumber, WireFormat.WIRETYPE_END_GROUP);
+	  	output.writeInt32(1, 9);
+	  	output.writeInt32(30, 1);
+	  	return bytes;
+	  }
+
+	  private function testGroupRoundTrip():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.mutableOptionalGroup().a = 7;
+	  	message.optionalInt32 = 3;
+	  	var bytes:ByteArray = message.toByteArray();
+	  	check(bytes.length == message.getSerializedSize(), "group size");
+
+	  	// The group is framed by its start and end tags, 20 << 3 | 3 and
+	  	// 20 << 3 | 4, each a two byte varint.
+	  	var start:int = -1;
+	  	var end:int = -1;
+	  	for (var i:int = 0; i + 1 < bytes.length; i++) {
+	  		if (bytes[i] == 0xA3 && bytes[i + 1] == 0x01) start = i;
+	  		if (bytes[i] == 0xA4 && bytes[i + 1] == 0x01) end = i;
+	  	}
+	  	check(start >= 0 && end > start, "group tags");
+
+	  	var copy:AllTypes = parse(bytes);
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "group value");
+	  	// Parsing does not stop at the end of the group.
+	  	check(copy.optionalInt32 == 3 && copy.requiredInt32 == 1, "fields after the group");
+	  }
+
+	  private function testUnknownGroupSkipped():void {
+	  	var copy:AllTypes = parse(withUnknownGroup(60));
+	  	check(copy.optionalInt32 == 9, "field after an unknown group");
+	  	check(copy.requiredInt32 == 1, "last field after an unknown group");
+	  }
+
+	  private function testSlicedDecoderRejectsEndGroup():void {
+	  	// An end group tag of an unknown field, with no group open.
+	  	var bytes:ByteArray = new ByteArray();
+	  	var output:CodedOutputStream = CodedOutputStream.newInstance(bytes);
+	  	output.writeInt32(1, 9);
+	  	output.writeTag(60, WireFormat.WIRETYPE_END_GROUP);
+	  	output.writeInt32(30, 1);
+	  	bytes.position = 0;
+
+	  	var decoder:SlicedDecoder = new SlicedDecoder(new AllTypes(), bytes, 0);
+	  	check(decoder.step(STEP_MS), "stray end group decoded");
+	  	check(decoder.error is InvalidProtocolBufferException, "stray end group rejected");
+	  }
+
+	  private function testSlicedDecoderReadsGroup():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.mutableOptionalGroup().a = 7;
+	  	message.optionalInt32 = 3;
+	  	var bytes:ByteArray = message.toByteArray();
+	  	bytes.position = 0;
+
+	  	var decoder:SlicedDecoder = new SlicedDecoder(new AllTypes(), bytes, 0);
+	  	check(decoder.step(STEP_MS), "group decoded");
+	  	check(decoder.error == null, "group decoded without error");
+	  	var copy:AllTypes = AllTypes(decoder.message);
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "sliced group value");
+	  	check(copy.optionalInt32 == 3, "sliced field after the group");
+
+	  	bytes = withUnknownGroup(60);
+	  	bytes.position = 0;
+	  	decoder = new SlicedDecoder(new AllTypes(), bytes, 0);
+	  	decoder.step(STEP_MS);
+	  	check(decoder.error == null, "sliced unknown group skipped");
+	  	check(AllTypes(decoder.message).optionalInt32 == 9, "sliced field after an unknown group");
+	  }
+
+	  private function testSlicedDecoderLiteRoot():void {
+	  	var bytes:ByteArray = new ByteArray();
+	  	var output:CodedOutputStream = CodedOutputStream.newInstance(bytes);
+	  	output.writeInt32(2, 4);
+	  	output.writeInt32(1, 5);
+	  	bytes.position = 0;
+
+	  	var decoder:SlicedDecoder = new SlicedDecoder(new LiteMessage(), bytes, 0);
+	  	check(decoder.step(STEP_MS), "lite root decoded");
+	  	check(decoder.error == null, "lite root decoded without error");
+	  	check(LiteMessage(decoder.message).value == 5, "lite root field");
+	  }
+
+	  private function testFieldRegisteredLater():void {
+	  	var message:LateFields = new LateFields();
+	  	message.some_value = 3;
+	  	check(message.getDescriptorByFieldNumber(1) != null, "late field by number");
+	  	check(message.getDescriptorByTextName("some_value") != null, "late field by text name");
+	  	check(message.getDescriptorByJsonName("someValue") != null, "late field by JSON name");
+
+	  	var copy:LateFields = new LateFields();
+	  	var bytes:ByteArray = message.toByteArray();
+	  	bytes.position = 0;
+	  	copy.readFromDataOutput(bytes);
+	  	check(copy.some_value == 3, "late field round trip");
+	  }
+
+	  private function testJsonNames():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.value2X = 2;
+	  	message.fooBar = 4;
+	  	message.mutableOptionalGroup().a = 7;
+	  	var json:String = message.toJSONString();
+	  	// The names protoc derives from the .proto names, not the As3 ones.
+	  	check(json.indexOf('"value2x":2') >= 0, "json name value2x");
+	  	check(json.indexOf('"fooBar":4') >= 0, "json name fooBar");
+	  	check(json.indexOf('"requiredInt32":1') >= 0, "json name requiredInt32");
+	  	check(json.indexOf('"optionalgroup":{') >= 0, "json name of the group");
+	  	check(json.indexOf("value2X") < 0, "no As3 name in json");
+	  }
+
+	  private function testJsonRoundTrip():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.optionalString = "a\"b";
+	  	message.value2X = 2;
+	  	message.fooBar = 4;
+	  	message.mutableOptionalGroup().a = 7;
+	  	message.repeatedInt32.push(1, 2);
+
+	  	var copy:AllTypes = new AllTypes();
+	  	copy.mergeFromJSON(message.toJSONString());
+	  	check(copy.optionalString == "a\"b", "json string");
+	  	check(copy.value2X == 2 && copy.fooBar == 4, "json names");
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "json group");
+	  	check(copy.repeatedInt32.length == 2, "json repeated");
+
+	  	// Both the JSON and the .proto names are accepted.
+	  	copy = new AllTypes();
+	  	copy.mergeFromJSON('{"optional_int32": 5, "optionalUint32": 6, "optionalgroup": {"a": 8}}');
+	  	check(copy.optionalInt32 == 5 && copy.optionalUint32 == 6, "json .proto names");
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 8, "json group name");
+	  }
+
+	  private function testJsonUnknownMember():void {
+	  	checkThrows(function():void {
+	  		new AllTypes().mergeFromJSON('{"noSuchField": 1}');
+	  	}, "unknown json member");
+	  	checkThrows(function():void {
+	  		new AllTypes().mergeFromJSON('{"optionalNested": {"noSuchField": 1}}');
+	  	}, "unknown nested json member");
+	  	checkThrows(function():void {
+	  		new AllTypes().mergeFromJSON('{"optionalgroup": {"b": 1}}');
+	  	}, "unknown group json member");
+	  	// The As3 name is neither the JSON nor the .proto name.
+	  	checkThrows(function():void {
+	  		new AllTypes().mergeFromJSON('{"value2X": 1}');
+	  	}, "As3 name in json");
+	  }
+
+	  private function testTextNames():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.value2X = 2;
+	  	message.fooBar = 4;
+	  	message.mutableOptionalGroup().a = 7;
+	  	var text:String = message.toText();
+	  	// The names of the .proto file, not the ones derived from the As3
+	  	// names, which would be "value2_x" and "foo_bar".
+	  	check(text.indexOf("value2x: 2\n") >= 0, "text name value2x");
+	  	check(text.indexOf("fooBar: 4\n") >= 0, "text name fooBar");
+	  	check(text.indexOf("OptionalGroup {\n") >= 0, "text name of the group");
+
+	  	var copy:AllTypes = new AllTypes();
+	  	copy.mergeFromText("value2x: 5 fooBar: 6 OptionalGroup { a: 9 } required_int32: 1");
+	  	check(copy.value2X == 5 && copy.fooBar == 6, "text names parsed");
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 9, "text group parsed");
+
+	  	checkThrows(function():void {
+	  		new AllTypes().mergeFromText("value2_x: 1");
+	  	}, "derived text name");
+	  }
+
+	  private function testTextRoundTrip():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.optionalString = "line\nbreak";
+	  	message.optionalDouble = 0.5;
+	  	message.mutableOptionalNested().mutableChild().label = "inner";
+	  	message.repeatedString.push("x", "y");
+
+	  	var copy:AllTypes = new AllTypes();
+	  	copy.mergeFromText(message.toText());
+	  	check(copy.toText() == message.toText(), "text round trip");
+	  	check(copy.getOptionalNested().getChild().label == "inner", "text nested");
+	  }
+
+	  private function newMaskedMessage():AllTypes {
+	  	var message:AllTypes = newAllTypes();
+	  	message.optionalInt32 = 1;
+	  	message.optionalString = "s";
+	  	message.value2X = 2;
+	  	message.fooBar = 4;
+	  	message.mutableOptionalNested().label = "a";
+	  	message.mutableOptionalNested().mutableChild().label = "b";
+	  	message.mutableOptionalGroup().a = 7;
+	  	return message;
+	  }
+
+	  private function testMaskedWrite():void {
+	  	// .proto and actionscript paths, a nested sub mask and a group
+	  	var mask:FieldMask = FieldMask.fromString(
+	  		"optional_int32,optionalNested.child.label,OptionalGroup.a,value2x");
+	  	var bytes:ByteArray = new ByteArray();
+	  	newMaskedMessage().writeToDataOutput(bytes, mask);
+
+	  	var copy:AllTypes = parse(bytes);
+	  	check(copy.optionalInt32 == 1, "masked write of a .proto path");
+	  	check(copy.value2X == 2, "masked write of value2x");
+	  	check(copy.optionalString != "s" && copy.fooBar != 4, "masked write of unselected fields");
+	  	check(copy.optionalNested != null && copy.optionalNested.label != "a", "masked write of a sub mask");
+	  	check(copy.optionalNested.child != null && copy.optionalNested.child.label == "b", "masked write of a nested sub mask");
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "masked write of a group");
+	  	check(copy.requiredInt32 != 1, "masked write of the required field");
+	  }
+
+	  private function testMaskedRead():void {
+	  	var bytes:ByteArray = newMaskedMessage().toByteArray();
+	  	bytes.position = 0;
+	  	var copy:AllTypes = new AllTypes();
+	  	copy.readFromDataOutput(bytes, new FieldMask(["optionalNested.label", "optionalgroup.a", "fooBar"]));
+	  	check(copy.fooBar == 4, "masked read of fooBar");
+	  	check(copy.optionalInt32 != 1 && copy.value2X != 2, "masked read of unselected fields");
+	  	check(copy.optionalNested != null && copy.optionalNested.label == "a", "masked read of a sub mask");
+	  	check(copy.optionalNested.child == null, "masked read of an unselected sub field");
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "masked read of a group");
+	  	check(copy.requiredInt32 != 1, "masked read of the required field");
+
+	  	bytes.position = 0;
+	  	copy = new AllTypes();
+	  	copy.readFromDataOutput(bytes, FieldMask.fromString("OptionalGroup,value2x"));
+	  	check(copy.optionalGroup != null && copy.optionalGroup.a == 7, "masked read of a whole group");
+	  	check(copy.value2X == 2, "masked read of value2x");
+	  }
+
+	  private function testExtensionRoundTrip():void {
+	  	var message:AllTypes = newAllTypes();
+	  	message.setExtension(As3Unittest.extensionInt32, 11);
+	  	var item:Item = new Item();
+	  	item.id = 12;
+	  	message.addExtension(As3Unittest.extensionItems, item);
+
+	  	var copy:AllTypes = parse(message.toByteArray());
+	  	check(copy.getExtension(As3Unittest.extensionInt32) == 11, "extension value");
+	  	var items:Array = copy.getExtension(As3Unittest.extensionItems);
+	  	check(items != null && items.length == 1 && items[0].id == 12, "repeated extension");
+	  }
+
+	  private function testDefaultInstance():void {
+	  	var message:AllTypes = newAllTypes();
+	  	check(message.getOptionalNested() == Nested.getDefaultInstance(), "unset field reads as the default instance");
+	  	check(message.optionalNested == null, "reading does not set the field");
+
+	  	var nested:Nested = message.mutableOptionalNested();
+	  	check(nested != Nested.getDefaultInstance() && !nested.isFrozen, "mutable accessor sets a new instance");
+	  	check(message.getOptionalNested() == nested, "get accessor returns the set field");
+
+	  	var thrown:Boolean = false;
+	  	try {
+	  		Nested.getDefaultInstance().label = "a";
+	  	} catch (e:IllegalOperationError) {
+	  		thrown = true;
+	  	}
+	  	check(thrown, "setting a field of the default instance should throw");
+	  	check(Nested.getDefaultInstance().label != "a", "default instance unchanged");
+	  }
+
+	  private function testWorkerDecoderRingFull():void {
+	  	// The smallest ring, 1024 bytes, too small for the frame: it is
+	  	// decoded right away
+	  	var decoder:WorkerDecoder = new WorkerDecoder(loaderInfo.bytes, [AllTypes], 1024);
+	  	var message:AllTypes = newAllTypes();
+	  	message.optionalString = new Array(2000).join("x");
+	  	var bytes:ByteArray = new ByteArray();
+	  	bytes.writeByte(0xFF);
+	  	message.writeToDataOutput(bytes);
+	  	// Not at 0, so the frame is copied out of bytes first.
+	  	bytes.position = 1;
+
+	  	var decoded:AllTypes = null;
+	  	var error:Error = null;
+	  	decoder.decode(AllTypes, bytes, function(m:Message, e:Error):void {
+	  		decoded = AllTypes(m);
+	  		error = e;
+	  	});
+	  	decoder.dispose();
+	  	check(error == null, "ring full decode error");
+	  	check(decoded != null && decoded.optionalString == message.optionalString, "ring full decode");
+	  	check(decoded != null && decoded.requiredInt32 == 1, "ring full decode of the last field");
+	  }
+
+	  private function testSocketRpcChannelMalformedFrame():void {
+	  	var socket:FakeSocket = new FakeSocket();
+	  	var channel:SocketRpcChannel = new SocketRpcChannel(socket);
+	  	// A frame length which is not a varint
+	  	for (var i:int = 0; i < 6; i++)
+	  		socket.data.writeByte(0xFF);
+	  	socket.data.position = 0;
+	  	try {
+	  		socket.dispatchEvent(new ProgressEvent(ProgressEvent.SOCKET_DATA));
+	  	} catch (e:Error) {
+	  		check(false, "malformed frame error thrown out of the handler");
+	  	}
+	  	check(!socket.connected, "socket closed on a malformed frame");
+
+	  	var error:Error = null;
+	  	channel.callMethod("Service.Method", newAllTypes(), AllTypes, function(m:Message, e:Error):void {
+	  		error = e;
+	  	});
+	  	check(error != null, "call on a channel closed by a malformed frame");
+	  }
+	}
+}
+
+import com.google.protobuf.CodedInputStream;
+import com.google.protobuf.Descriptor;
+import com.google.protobuf.FieldMask;
+import com.google.protobuf.Message;
+import flash.net.Socket;
+import flash.utils.ByteArray;
+
+/** Decodes like a LITE message, without descriptors. */
+class LiteMessage extends Message {
+
+  public var value:int;
+
+  override public function readFromCodedStream(input:CodedInputStream, mask:FieldMask = null):void {
+  	var tag:int;
+  	while ((tag = input.readTag()) != 0) {
+  		if (tag == 8)
+  			value = input.readInt32();
+  		else if (!input.skipField(tag))
+  			return;
+  	}
+  }
+}
+
+/** A hand written message, registering its field once Message() registered the class. */
+class LateFields extends Message {
+
+  public var some_value:int;
+
+  public function LateFields() {
+  	registerField("some_value", null, Descriptor.INT32, Descriptor.LABEL_OPTIONAL, 1);
+  }
+}
+
+/** A connected Socket whose received bytes are data. */
+class FakeSocket extends Socket {
+
+  public var data:ByteArray = new ByteArray();
+  private var open:Boolean = true;
+
+  override public function get connected():Boolean {
+  	return open;
+  }
+
+  override public function close():void {
+  	open = false;
+  }
+
+  override public function readBytes(bytes:ByteArray, offset:uint = 0, length:uint = 0):void {
+  	data.readBytes(bytes, offset, length);
+  }
+}
@@ -0,0 +1,308 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmark of the As3 generator on synthetic schemas, run by
+// "make benchmark".  Each schema is built as a FileDescriptorProto, then
+// generated with As3Generator::Generate() into memory, once per optimize
+// mode:
+//
+//   as3bench [shape] [--messages=N] [--fields=N] [--depth=N] [--enums=N]
+//            [--values=N] [--iterations=N] [--parameter=P]
+//
+// The shapes are many (thousands of small messages), deep (nested messages),
+// wide (messages with many fields) and enums (many big enums); all of them
+// run by default.  The options override the size of the shape, --parameter
+// is added to the generator parameter, e.g. --parameter=threads=4.
+//
+// Every phase reports its wall time, the peak RSS of the process in KB once it
+// ran, and for generation the files and bytes emitted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/compiler/as3/as3_generator.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/strutil.h>
+
+using namespace std;
+using namespace google::protobuf;
+using google::protobuf::compiler::OutputDirectory;
+using google::protobuf::compiler::as3::As3Generator;
+using google::protobuf::io::StringOutputStream;
+using google::protobuf::io::ZeroCopyOutputStream;
+
+namespace {
+
+struct Shape {
+  const char* name;
+  int messages;    // Top level messages.
+  int fields;      // Fields per message.
+  int depth;       // Levels of messages nested in each top level one.
+  int enums;
+  int values;      // Values per enum.
+};
+
+const Shape kShapes[] = {
+  // name     messages  fields  depth  enums  values
+  { "many",   4000,     8,      0,     20,    8    },
+  { "deep",   200,      8,      10,    0,     0    },
+  { "wide",   50,       1000,   0,     0,     0    },
+  { "enums",  10,       8,      0,     1000,  100  },
+};
+
+// The field types the messages cycle through; enum and message fields are
+// only used when the schema has enums, respectively more than one message.
+const FieldDescriptorProto::Type kFieldTypes[] = {
+  FieldDescriptorProto::TYPE_INT32,
+  FieldDescriptorProto::TYPE_STRING,
+  FieldDescriptorProto::TYPE_INT64,
+  FieldDescriptorProto::TYPE_MESSAGE,
+  FieldDescriptorProto::TYPE_BOOL,
+  FieldDescriptorProto::TYPE_DOUBLE,
+  FieldDescriptorProto::TYPE_ENUM,
+  FieldDescriptorProto::TYPE_UINT32,
+  FieldDescriptorProto::TYPE_BYTES,
+  FieldDescriptorProto::TYPE_SINT64,
+  FieldDescriptorProto::TYPE_FIXED32,
+  FieldDescriptorProto::TYPE_FLOAT,
+};
+
+// Keeps the generated files in memory, counting what was emitted.
+class MemoryOutputDirectory : public OutputDirectory {
+ public:
+  MemoryOutputDirectory() : files_(0) {}
+
+  ZeroCopyOutputStream* Open(const string& filename) {
+    files_++;
+    contents_.push_back(string());
+    return new StringOutputStream(&contents_.back());
+  }
+
+  ZeroCopyOutputStream* OpenForInsert(const string& filename,
+                                      const string& insertion_point) {
+    contents_.push_back(string());
+    return new StringOutputStream(&contents_.back());
+  }
+
+  int files() const { return files_; }
+
+  long bytes() const {
+    long bytes = 0;
+    for (list<string>::const_iterator i = contents_.begin();
+         i != contents_.end(); ++i) {
+      bytes += i->size();
+    }
+    return bytes;
+  }
+
+ private:
+  int files_;
+  // A list, so the streams keep pointing at their strings.
+  list<string> contents_;
+};
+
+double Now() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec * 1000.0 + now.tv_usec / 1000.0;
+}
+
+// The peak resident set size, in KB.
+long PeakRss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;  // Bytes there, KB on Linux and the BSDs.
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+void Report(const string& phase, double start, int files, long bytes) {
+  printf("  %-24s %10.1f %12ld", phase.c_str(), Now() - start, PeakRss());
+  if (files > 0) printf(" %8d %12ld", files, bytes);
+  printf("\n");
+}
+
+void AddFields(const Shape& shape, int message, DescriptorProto* descriptor) {
+  int types = sizeof(kFieldTypes) / sizeof(kFieldTypes[0]);
+  for (int i = 0; i < shape.fields; i++) {
+    FieldDescriptorProto* field = descriptor->add_field();
+    field->set_name("field_number_" + SimpleItoa(i));
+    field->set_number(i + 1);
+    field->set_label(i % 3 == 2 ? FieldDescriptorProto::LABEL_REPEATED
+                                : FieldDescriptorProto::LABEL_OPTIONAL);
+    FieldDescriptorProto::Type type = kFieldTypes[i % types];
+    if (type == FieldDescriptorProto::TYPE_ENUM && shape.enums > 0 &&
+        shape.values > 0) {
+      field->set_type_name(".bench.Enum" + SimpleItoa(i % shape.enums));
+    } else if (type == FieldDescriptorProto::TYPE_MESSAGE &&
+               shape.messages > 1) {
+      // The previous message, so references do not only go one way.
+      field->set_type_name(
+        ".bench.Message" + SimpleItoa((message + shape.messages - 1) %
+                                      shape.messages));
+    } else if (type == FieldDescriptorProto::TYPE_ENUM ||
+               type == FieldDescriptorProto::TYPE_MESSAGE) {
+      type = FieldDescriptorProto::TYPE_INT32;
+    }
+    field->set_type(type);
+  }
+}
+
+void Synthesize(const Shape& shape, FileDescriptorProto* file) {
+  file->set_name(string("bench_") + shape.name + ".proto");
+  file->set_package("bench");
+  for (int i = 0; i < shape.messages; i++) {
+    DescriptorProto* message = file->add_message_type();
+    message->set_name("Message" + SimpleItoa(i));
+    AddFields(shape, i, message);
+    // Nested class names must be unique in the package.
+    for (int level = 1; level <= shape.depth; level++) {
+      message = message->add_nested_type();
+      message->set_name(
+        "Message" + SimpleItoa(i) + "Level" + SimpleItoa(level));
+      AddFields(shape, i, message);
+    }
+  }
+  for (int i = 0; i < shape.enums && shape.values > 0; i++) {
+    EnumDescriptorProto* enum_type = file->add_enum_type();
+    enum_type->set_name("Enum" + SimpleItoa(i));
+    for (int j = 0; j < shape.values; j++) {
+      EnumValueDescriptorProto* value = enum_type->add_value();
+      // Enum values are scoped like their enum.
+      value->set_name("ENUM" + SimpleItoa(i) + "_VALUE" + SimpleItoa(j));
+      value->set_number(j + 1);
+    }
+  }
+}
+
+bool Run(const Shape& shape, int iterations, const string& parameter) {
+  printf("%s: %d messages, %d fields, depth %d, %d enums, %d values\n",
+         shape.name, shape.messages, shape.fields, shape.depth, shape.enums,
+         shape.values);
+  printf("  %-24s %10s %12s %8s %12s\n",
+         "phase", "wall ms", "peak RSS KB", "files", "bytes");
+
+  double start = Now();
+  FileDescriptorProto file_proto;
+  Synthesize(shape, &file_proto);
+  Report("synthesize", start, 0, 0);
+
+  start = Now();
+  DescriptorPool pool;
+  const FileDescriptor* file = pool.BuildFile(file_proto);
+  if (file == NULL) {
+    fprintf(stderr, "%s: the synthesized schema is invalid.\n", shape.name);
+    return false;
+  }
+  Report("build descriptors", start, 0, 0);
+
+  const char* modes[] = { "speed", "code_size", "lite" };
+  As3Generator generator;
+  for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+    string generator_parameter = string("optimize=") + modes[i];
+    if (!parameter.empty()) generator_parameter += "," + parameter;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+      start = Now();
+      MemoryOutputDirectory output;
+      string error;
+      if (!generator.Generate(file, generator_parameter, &output, &error)) {
+        fprintf(stderr, "%s: %s\n", shape.name, error.c_str());
+        return false;
+      }
+      Report(string("generate ") + modes[i], start, output.files(),
+             output.bytes());
+    }
+  }
+  return true;
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [many|deep|wide|enums] [--messages=N] [--fields=N]\n"
+          "         [--depth=N] [--enums=N] [--values=N] [--iterations=N]\n"
+          "         [--parameter=P]\n"
+          "  Generates As3 code for synthetic schemas in memory, reporting\n"
+          "  the time, peak RSS and output of each phase.\n",
+          program);
+  return 2;
+}
+
+// Parses "--name=N" into *value.
+bool ParseFlag(const char* arg, const char* name, int* value) {
+  int length = strlen(name);
+  if (strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+  *value = atoi(arg + length + 1);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int shape_count = sizeof(kShapes) / sizeof(kShapes[0]);
+  vector<Shape> shapes(kShapes, kShapes + shape_count);
+  int iterations = 1;
+  string parameter;
+
+  Shape overrides = { NULL, -1, -1, -1, -1, -1 };
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--parameter=", 12) == 0) {
+      parameter = argv[i] + 12;
+    } else if (ParseFlag(argv[i], "--messages", &overrides.messages) ||
+               ParseFlag(argv[i], "--fields", &overrides.fields) ||
+               ParseFlag(argv[i], "--depth", &overrides.depth) ||
+               ParseFlag(argv[i], "--enums", &overrides.enums) ||
+               ParseFlag(argv[i], "--values", &overrides.values) ||
+               ParseFlag(argv[i], "--iterations", &iterations)) {
+      continue;
+    } else if (argv[i][0] != '-' && overrides.name == NULL) {
+      overrides.name = argv[i];
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+
+  if (overrides.name != NULL) {
+    shapes.clear();
+    for (int i = 0; i < shape_count; i++) {
+      if (strcmp(kShapes[i].name, overrides.name) == 0) {
+        shapes.push_back(kShapes[i]);
+      }
+    }
+    if (shapes.empty()) return Usage(argv[0]);
+  }
+  for (size_t i = 0; i < shapes.size(); i++) {
+    if (overrides.messages >= 0) shapes[i].messages = overrides.messages;
+    if (overrides.fields >= 0) shapes[i].fields = overrides.fields;
+    if (overrides.depth >= 0) shapes[i].depth = overrides.depth;
+    if (overrides.enums >= 0) shapes[i].enums = overrides.enums;
+    if (overrides.values >= 0) shapes[i].values = overrides.values;
+  }
+
+  for (size_t i = 0; i < shapes.size(); i++) {
+    if (!Run(shapes[i], iterations, parameter)) return 1;
+  }
+  return 0;
+}
@@ -32,8 +32,10 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
-EnumGenerator::EnumGenerator(const EnumDescriptor* descriptor)
-  : descriptor_(descriptor) {
+EnumGenerator::EnumGenerator(const EnumDescriptor* descriptor,
+                             const GeneratorOptions& options)
+  : descriptor_(descriptor),
+    options_(options) {
   for (int i = 0; i < descriptor_->value_count(); i++) {
     const EnumValueDescriptor* value = descriptor_->value(i);
     const EnumValueDescriptor* canonical_value =
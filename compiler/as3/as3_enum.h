@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/compiler/as3/as3_options.h>
 
 namespace google {
 namespace protobuf {
@@ -38,13 +39,15 @@ namespace as3 {
 
 class EnumGenerator {
  public:
-  explicit EnumGenerator(const EnumDescriptor* descriptor);
+  EnumGenerator(const EnumDescriptor* descriptor,
+                const GeneratorOptions& options);
   ~EnumGenerator();
 
   void Generate(io::Printer* printer);
 
  private:
   const EnumDescriptor* descriptor_;
+  const GeneratorOptions& options_;
 
   // The proto language allows multiple enum constants to have the same numeric
   // value.  As3, however, does not allow multiple enum constants to be
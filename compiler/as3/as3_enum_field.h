@@ -21,7 +21,6 @@
 #ifndef GOOGLE_PROTOBUF_COMPILER_AS3_ENUM_FIELD_H__
 #define GOOGLE_PROTOBUF_COMPILER_AS3_ENUM_FIELD_H__
 
-#include <map>
 #include <string>
 #include <google/protobuf/compiler/as3/as3_field.h>
 
@@ -32,7 +31,8 @@ namespace as3 {
 
 class EnumFieldGenerator : public FieldGenerator {
  public:
-  explicit EnumFieldGenerator(const FieldDescriptor* descriptor);
+  EnumFieldGenerator(const FieldDescriptor* descriptor,
+                      const FieldMetadata& metadata);
   ~EnumFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
@@ -43,19 +43,23 @@ class EnumFieldGenerator : public FieldGenerator {
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(EnumFieldGenerator);
 };
 
 class RepeatedEnumFieldGenerator : public FieldGenerator {
  public:
-  explicit RepeatedEnumFieldGenerator(const FieldDescriptor* descriptor);
+  RepeatedEnumFieldGenerator(const FieldDescriptor* descriptor,
+                              const FieldMetadata& metadata);
   ~RepeatedEnumFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
@@ -66,12 +70,15 @@ class RepeatedEnumFieldGenerator : public FieldGenerator {
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(RepeatedEnumFieldGenerator);
 };
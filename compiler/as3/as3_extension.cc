@@ -20,6 +20,7 @@
 
 #include <google/protobuf/compiler/as3/as3_extension.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
+#include <google/protobuf/compiler/as3/as3_metadata.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/io/printer.h>
 
@@ -28,51 +29,49 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
-ExtensionGenerator::ExtensionGenerator(const FieldDescriptor* descriptor)
-  : descriptor_(descriptor) {}
+ExtensionGenerator::ExtensionGenerator(const FieldDescriptor* descriptor,
+                                       const FieldMetadata& metadata)
+  : descriptor_(descriptor),
+    metadata_(metadata) {}
 
 ExtensionGenerator::~ExtensionGenerator() {}
 
 void ExtensionGenerator::Generate(io::Printer* printer) {
   map<string, string> vars;
-  vars["name"] = UnderscoresToCamelCase(descriptor_);
-  vars["containing_type"] = ClassName(descriptor_->containing_type());
-  vars["index"] = SimpleItoa(descriptor_->index());
-
-  As3Type as3_type = GetAs3Type(descriptor_);
-  string singular_type;
-  switch (as3_type) {
-    case AS3TYPE_MESSAGE:
-      vars["type"] = ClassName(descriptor_->message_type());
-      break;
-    case AS3TYPE_ENUM:
-      vars["type"] = ClassName(descriptor_->enum_type());
-      break;
-    default:
-      vars["type"] = BoxedPrimitiveTypeName(as3_type);
-      break;
+  vars["name"] = metadata_.name;
+  vars["full_name"] = descriptor_->full_name();
+  vars["containing_type"] =
+    QualifiedMessageClassName(descriptor_->containing_type());
+  vars["type"] = AllCapsTypeName(descriptor_->type());
+  vars["label"] = LabelName(descriptor_->label());
+  vars["number"] = SimpleItoa(descriptor_->number());
+  vars["message_type"] = "null";
+  if (descriptor_->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    vars["message_type"] = metadata_.type_class;
   }
 
-  //if (descriptor_->is_repeated()) {
-  //  printer->Print(vars,
-  //    "public static final\n"
-  //    "  com.google.protobuf.GeneratedMessage.GeneratedExtension<\n"
-  //    "    $containing_type$,\n"
-  //    "    as3.util.List<$type$>> $name$ =\n"
-  //    "      com.google.protobuf.GeneratedMessage\n"
-  //    "        .newRepeatedGeneratedExtension(\n"
-  //    "          getDescriptor().getExtensions().get($index$),\n"
-  //    "          $type$.class);\n");
-  //} else {
-  //  printer->Print(vars,
-  //    "public static final\n"
-  //    "  com.google.protobuf.GeneratedMessage.GeneratedExtension<\n"
-  //    "    $containing_type$,\n"
-  //    "    $type$> $name$ =\n"
-  //    "      com.google.protobuf.GeneratedMessage.newGeneratedExtension(\n"
-  //    "        getDescriptor().getExtensions().get($index$),\n"
-  //    "        $type$.class);\n");
-  //}
+  // The constant adds itself to the generated registry when its class is
+  // initialized, which its first use does.
+  printer->Print(vars,
+    "public static const $name$:ExtensionDescriptor =\n"
+    "  ExtensionRegistry.generated.add(new ExtensionDescriptor(\"$full_name$\",\n"
+    "    $containing_type$, $message_type$,\n"
+    "    Descriptor.$type$, Descriptor.$label$, $number$));\n");
+}
+
+void ExtensionGenerator::GenerateRegistrationCode(io::Printer* printer) {
+  string scope;
+  if (descriptor_->extension_scope() != NULL) {
+    scope = QualifiedMessageClassName(descriptor_->extension_scope());
+  } else {
+    scope = FileClassName(descriptor_->file());
+    string package = FileAs3Package(descriptor_->file());
+    if (!package.empty()) scope = package + "." + scope;
+  }
+  printer->Print(
+    "registry.add($scope$.$name$);\n",
+    "scope", scope,
+    "name", metadata_.name);
 }
 
 }  // namespace as3
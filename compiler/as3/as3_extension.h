@@ -35,18 +35,27 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
+struct FieldMetadata;          // as3_metadata.h
+
 // Generates code for an extension, which may be within the scope of some
 // message or may be at file scope.  This is much simpler than FieldGenerator
 // since extensions are just simple identifiers with interesting types.
 class ExtensionGenerator {
  public:
-  explicit ExtensionGenerator(const FieldDescriptor* descriptor);
+  ExtensionGenerator(const FieldDescriptor* descriptor,
+                     const FieldMetadata& metadata);
   ~ExtensionGenerator();
 
+  // Prints the static ExtensionDescriptor constant of the extension.
   void Generate(io::Printer* printer);
 
+  // Prints the statement adding the extension to the ExtensionRegistry
+  // named "registry".
+  void GenerateRegistrationCode(io::Printer* printer);
+
  private:
   const FieldDescriptor* descriptor_;
+  const FieldMetadata& metadata_;
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ExtensionGenerator);
 };
 
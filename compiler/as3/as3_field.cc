@@ -24,48 +24,86 @@
 #include <google/protobuf/compiler/as3/as3_enum_field.h>
 #include <google/protobuf/compiler/as3/as3_message_field.h>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
 
 namespace google {
 namespace protobuf {
 namespace compiler {
 namespace as3 {
 
+FieldGenerator::FieldGenerator(const FieldDescriptor* descriptor,
+                               const FieldMetadata& metadata) {
+  values_[SLOT_NAME] = metadata.name;
+  values_[SLOT_CAPITALIZED_NAME] = metadata.capitalized_name;
+  values_[SLOT_NUMBER] = metadata.number;
+  values_[SLOT_TEXT_NAME] = metadata.text_name;
+  values_[SLOT_JSON_NAME] = metadata.json_name;
+  values_[SLOT_PARENT] = metadata.parent;
+  values_[SLOT_TAG] = SimpleItoa(metadata.tag);
+  values_[SLOT_TAG_SIZE] = metadata.tag_size;
+  values_[SLOT_WRITE_TAG] = metadata.write_tag;
+  values_[SLOT_WRITE_END_TAG] = metadata.write_end_tag;
+  values_[SLOT_DESCRIPTOR_TYPE] = AllCapsTypeName(descriptor->type());
+  values_[SLOT_DESCRIPTOR_LABEL] = LabelName(descriptor->label());
+  values_[SLOT_TABLE_SLOT] = metadata.slot;
+  // The private member holding the field in SPEED and LITE_RUNTIME messages.
+  values_[SLOT_MEMBER_NAME] = "_" + metadata.name;
+
+  // Message fields hold a reference to the class, which also keeps it
+  // linked in the SWF.  The FieldTable holds the value names of enum
+  // fields instead, for the text format.
+  values_[SLOT_MESSAGE_CLASS] = "null";
+  values_[SLOT_TABLE_CLASS] = "null";
+  if (descriptor->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    values_[SLOT_MESSAGE_CLASS] = metadata.type_class;
+    values_[SLOT_TABLE_CLASS] = metadata.type_class;
+  } else if (descriptor->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    values_[SLOT_TABLE_CLASS] = metadata.value_names;
+  }
+}
+
 FieldGenerator::~FieldGenerator() {}
 
-FieldGeneratorMap::FieldGeneratorMap(const Descriptor* descriptor)
+void FieldGenerator::GenerateTableMembers(io::Printer* printer) const {
+  Render(TABLE_MEMBERS, printer);
+}
+
+void FieldGenerator::Render(FieldTemplate id, io::Printer* printer) const {
+  GetFieldTemplate(id).Render(values_, printer);
+}
+
+FieldGeneratorMap::FieldGeneratorMap(const Descriptor* descriptor,
+                                     const MessageMetadata& metadata)
   : descriptor_(descriptor),
     field_generators_(
-      new scoped_ptr<FieldGenerator>[descriptor->field_count()]),
-    extension_generators_(
-      new scoped_ptr<FieldGenerator>[descriptor->extension_count()]) {
+      new scoped_ptr<FieldGenerator>[descriptor->field_count()]) {
 
   // Construct all the FieldGenerators.
   for (int i = 0; i < descriptor->field_count(); i++) {
-    field_generators_[i].reset(MakeGenerator(descriptor->field(i)));
-  }
-  for (int i = 0; i < descriptor->extension_count(); i++) {
-    extension_generators_[i].reset(MakeGenerator(descriptor->extension(i)));
+    const FieldDescriptor* field = descriptor->field(i);
+    field_generators_[i].reset(MakeGenerator(field, metadata.field(field)));
   }
 }
 
-FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field) {
+FieldGenerator* FieldGeneratorMap::MakeGenerator(
+    const FieldDescriptor* field, const FieldMetadata& metadata) {
   if (field->is_repeated()) {
     switch (GetAs3Type(field)) {
       case AS3TYPE_MESSAGE:
-        return new RepeatedMessageFieldGenerator(field);
+        return new RepeatedMessageFieldGenerator(field, metadata);
       case AS3TYPE_ENUM:
-        return new RepeatedEnumFieldGenerator(field);
+        return new RepeatedEnumFieldGenerator(field, metadata);
       default:
-        return new RepeatedPrimitiveFieldGenerator(field);
+        return new RepeatedPrimitiveFieldGenerator(field, metadata);
     }
   } else {
     switch (GetAs3Type(field)) {
       case AS3TYPE_MESSAGE:
-        return new MessageFieldGenerator(field);
+        return new MessageFieldGenerator(field, metadata);
       case AS3TYPE_ENUM:
-        return new EnumFieldGenerator(field);
+        return new EnumFieldGenerator(field, metadata);
       default:
-        return new PrimitiveFieldGenerator(field);
+        return new PrimitiveFieldGenerator(field, metadata);
     }
   }
 }
@@ -78,10 +116,6 @@ const FieldGenerator& FieldGeneratorMap::get(
   return *field_generators_[field->index()];
 }
 
-const FieldGenerator& FieldGeneratorMap::get_extension(int index) const {
-  return *extension_generators_[index];
-}
-
 }  // namespace as3
 }  // namespace compiler
 }  // namespace protobuf
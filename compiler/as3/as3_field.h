@@ -24,6 +24,8 @@
 #include <string>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/compiler/as3/as3_field_templates.h>
+#include <google/protobuf/compiler/as3/as3_metadata.h>
 
 namespace google {
 namespace protobuf {
@@ -36,40 +38,63 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
+// The subclasses print their code by rendering the field templates with
+// values_, see as3_field_templates.h.
 class FieldGenerator {
  public:
-  FieldGenerator() {}
+  // Sets the values of the slots shared by all fields, from the metadata.
+  FieldGenerator(const FieldDescriptor* descriptor,
+                 const FieldMetadata& metadata);
   virtual ~FieldGenerator();
 
   virtual void GenerateMembers(io::Printer* printer) const = 0;
+  // The members of CODE_SIZE messages, accessors to the field's slot of
+  // Message.fieldValues.  Message fields add their get and mutable ones.
+  virtual void GenerateTableMembers(io::Printer* printer) const;
   virtual void GenerateBuilderMembers(io::Printer* printer) const = 0;
   virtual void GenerateMergingCode(io::Printer* printer) const = 0;
   virtual void GenerateBuildingCode(io::Printer* printer) const = 0;
   virtual void GenerateParsingCode(io::Printer* printer) const = 0;
   virtual void GenerateSerializationCode(io::Printer* printer) const = 0;
   virtual void GenerateSerializedSizeCode(io::Printer* printer) const = 0;
+  // Text format, see TextWriter.as and TextTokenizer.as.
+  virtual void GenerateTextPrintingCode(io::Printer* printer) const = 0;
+  virtual void GenerateTextParsingCode(io::Printer* printer) const = 0;
+  // JSON, see JsonWriter.as and JsonReader.as.  The parsing code reads the
+  // JSON value of the field from the As3 variable "value".
+  virtual void GenerateJsonWritingCode(io::Printer* printer) const = 0;
+  virtual void GenerateJsonParsingCode(io::Printer* printer) const = 0;
 
   virtual string GetBoxedType() const = 0;
 
+  // Prints the template with the values of the field.
+  void Render(FieldTemplate id, io::Printer* printer) const;
+
+ protected:
+  // Indexed by FieldSlot.  The subclasses set the slots of their type.
+  string values_[FIELD_SLOT_COUNT];
+
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldGenerator);
 };
 
-// Convenience class which constructs FieldGenerators for a Descriptor.
+// Convenience class which constructs FieldGenerators for a Descriptor,
+// from the metadata of its fields.  Extensions are generated by
+// ExtensionGenerator instead.
 class FieldGeneratorMap {
  public:
-  explicit FieldGeneratorMap(const Descriptor* descriptor);
+  FieldGeneratorMap(const Descriptor* descriptor,
+                    const MessageMetadata& metadata);
   ~FieldGeneratorMap();
 
   const FieldGenerator& get(const FieldDescriptor* field) const;
-  const FieldGenerator& get_extension(int index) const;
 
  private:
   const Descriptor* descriptor_;
   scoped_array<scoped_ptr<FieldGenerator> > field_generators_;
-  scoped_array<scoped_ptr<FieldGenerator> > extension_generators_;
 
-  static FieldGenerator* MakeGenerator(const FieldDescriptor* field);
+  static FieldGenerator* MakeGenerator(const FieldDescriptor* field,
+                                       const FieldMetadata& metadata);
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FieldGeneratorMap);
 };
@@ -0,0 +1,551 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <google/protobuf/compiler/as3/as3_field_templates.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/once.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+namespace {
+
+// In the order of FieldSlot.
+const char* const kSlotNames[] = {
+  "name",
+  "capitalized_name",
+  "number",
+  "text_name",
+  "json_name",
+  "parent",
+  "tag",
+  "tag_size",
+  "write_tag",
+  "write_end_tag",
+  "descriptor_type",
+  "descriptor_label",
+  "message_class",
+  "table_class",
+  "table_slot",
+  "type",
+  "boxed_type",
+  "default",
+  "capitalized_type",
+  "text_type",
+  "java_package",
+  "value_names",
+  "element",
+  "write_value",
+  "value_size",
+  "fixed_size",
+  "member_type",
+  "member_default",
+  "member_name",
+};
+
+struct TemplateText {
+  FieldTemplate id;
+  const char* text;
+};
+
+const TemplateText kTemplates[] = {
+  // Every field -----------------------------------------------------
+
+  // Non LITE_RUNTIME messages register their fields by name, see
+  // Message.registerField().  The text format name is the one of the .proto
+  // file, which can't be derived back from the As3 name.
+  { REGISTER_FIELD,
+    "registerField(\"$name$\",$message_class$,"
+    "Descriptor.$descriptor_type$,Descriptor.$descriptor_label$,$number$,"
+    "\"$text_name$\");\n" },
+
+  // CODE_SIZE messages describe their fields in a FieldTable instead of
+  // generated codecs, see FieldTable.as.  The rows are separated by
+  // MessageGenerator.
+  { FIELD_TABLE_ROW,
+    "$tag$, Descriptor.$descriptor_type$, Descriptor.$descriptor_label$" },
+  { FIELD_TABLE_NAME,
+    "\"$name$\"" },
+  { FIELD_TABLE_TEXT_NAME,
+    "\"$text_name$\"" },
+  { FIELD_TABLE_JSON_NAME,
+    "\"$json_name$\"" },
+  { FIELD_TABLE_CLASS,
+    "$table_class$" },
+  // Their fields are held in Message.fieldValues, by slot, for the table to
+  // index rather than look them up by name.  The accessors keep the
+  // members of the other modes.
+  { FIELD_TABLE_DEFAULT,
+    "$member_default$" },
+  { TABLE_MEMBERS,
+    "public function get $name$():$member_type$ {\n"
+    "  return fieldValues[$table_slot$];\n"
+    "}\n"
+    "public function set $name$(value:$member_type$):void {\n"
+    "  checkMutable();\n"
+    "  fieldValues[$table_slot$] = value;\n"
+    "}\n" },
+  // SPEED and LITE_RUNTIME messages hold their fields in private members,
+  // which their generated codecs use directly.  The setters keep the
+  // frozen default instances read only, see Message.freeze().
+  { MEMBERS,
+    "private var $member_name$:$member_type$ = $member_default$;\n"
+    "public function get $name$():$member_type$ {\n"
+    "  return $member_name$;\n"
+    "}\n"
+    "public function set $name$(value:$member_type$):void {\n"
+    "  checkMutable();\n"
+    "  $member_name$ = value;\n"
+    "}\n" },
+
+  // Primitive fields --------------------------------------------------
+
+  { PRIMITIVE_BUILDER_MEMBERS,
+    "public function get$capitalized_name$():$type$  {\n"
+    "  return $name$;\n"
+    "}\n"
+    "public function set$capitalized_name$(value:$type$):$parent$ {\n"
+    "  $name$ = value;\n"
+    "  return this;\n"
+    "}\n"
+    "public function clear$capitalized_name$():$parent$ {\n"
+    "  $name$ = $default$;\n"
+    "  return this;\n"
+    "}\n" },
+  { PRIMITIVE_MERGING,
+    "if (other.has$capitalized_name$()) {\n"
+    "  set$capitalized_name$(other.get$capitalized_name$());\n"
+    "}\n" },
+  { PRIMITIVE_PARSING,
+    "$member_name$ = input.read$capitalized_type$();\n" },
+  // Strings, bytes and 64 bits integers may be null.
+  { PRIMITIVE_SERIALIZATION,
+    "$write_tag$\n"
+    "$write_value$\n" },
+  { NULLABLE_PRIMITIVE_SERIALIZATION,
+    "if ($member_name$ != null) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "}\n" },
+  { FIXED_PRIMITIVE_SERIALIZED_SIZE,
+    "size += $fixed_size$;\n" },
+  { PRIMITIVE_SERIALIZED_SIZE,
+    "size += $tag_size$ + $value_size$;\n" },
+  { NULLABLE_PRIMITIVE_SERIALIZED_SIZE,
+    "if ($member_name$ != null) {\n"
+    "  size += $tag_size$ + $value_size$;\n"
+    "}\n" },
+  { PRIMITIVE_TEXT_PRINTING,
+    "output.print$text_type$(\"$text_name$\", $member_name$);\n" },
+  { NULLABLE_PRIMITIVE_TEXT_PRINTING,
+    "if ($member_name$ != null) {\n"
+    "  output.print$text_type$(\"$text_name$\", $member_name$);\n"
+    "}\n" },
+  { PRIMITIVE_TEXT_PARSING,
+    "input.consume(\":\");\n"
+    "$member_name$ = input.consume$text_type$();\n" },
+  { PRIMITIVE_JSON_WRITING,
+    "output.write$text_type$(\"$json_name$\", $member_name$);\n" },
+  { NULLABLE_PRIMITIVE_JSON_WRITING,
+    "if ($member_name$ != null) {\n"
+    "  output.write$text_type$(\"$json_name$\", $member_name$);\n"
+    "}\n" },
+  { PRIMITIVE_JSON_PARSING,
+    "$member_name$ = JsonReader.parse$text_type$(value);\n" },
+
+  // Repeated primitive fields -----------------------------------------
+
+  { REPEATED_PRIMITIVE_BUILDER_MEMBERS,
+    "public function get$capitalized_name$List():Array {\n"
+    "  return $name$;\n"
+    "}\n"
+    "public function get$capitalized_name$Count():int {\n"
+    "  return $name$.length;\n"
+    "}\n"
+    "public function get$capitalized_name$(index:int):$type$ {\n"
+    "  return $name$[index];\n"
+    "}\n"
+    "public function set$capitalized_name$(index:int, value:$type$):$parent$ {\n"
+    "  $name$[index] = value;\n"
+    "  return this;\n"
+    "}\n"
+    "public function add$capitalized_name$(value:$type$):$parent$ {\n"
+    //"  if ($name$_.isEmpty()) {\n"
+    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
+    //"  }\n"
+    "  $name$.push(value);\n"
+    "  return this;\n"
+    "}\n"
+    "public function addAll$capitalized_name$(values:Array):$parent$ {\n"
+    //"  if ($name$_.isEmpty()) {\n"
+    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
+    //"  }\n"
+    "  $name$.concat(values);\n"
+    "  return this;\n"
+    "}\n"
+    "public function clear$capitalized_name$():$parent$  {\n"
+    "  $name$ = new Array();\n"
+    "  return this;\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_MERGING,
+    "if (!other.$name$_.isEmpty()) {\n"
+    "  if ($name$_.isEmpty()) {\n"
+    "    $name$_ = new ArrayList<$boxed_type$>();\n"
+    "  }\n"
+    "  $name$_.addAll(other.$name$_);\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_BUILDING,
+    "if ($name$_ != Collections.EMPTY_LIST) {\n"
+    "  $name$_ =\n"
+    "    Collections.unmodifiableList($name$_);\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_PARSING,
+    "$member_name$.push(input.read$capitalized_type$());\n" },
+  { REPEATED_PRIMITIVE_SERIALIZATION,
+    "for each (var $element$:$type$ in $member_name$) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "}\n" },
+  { FIXED_REPEATED_PRIMITIVE_SERIALIZED_SIZE,
+    "size += $fixed_size$ * $member_name$.length;\n" },
+  { REPEATED_PRIMITIVE_SERIALIZED_SIZE,
+    "for each (var $element$:$type$ in $member_name$) {\n"
+    "  size += $tag_size$ + $value_size$;\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_TEXT_PRINTING,
+    "for each (var $element$:$type$ in $member_name$) {\n"
+    "  output.print$text_type$(\"$text_name$\", $element$);\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_TEXT_PARSING,
+    "input.consume(\":\");\n"
+    "$member_name$.push(input.consume$text_type$());\n" },
+  { REPEATED_PRIMITIVE_JSON_WRITING,
+    "if ($member_name$.length > 0) {\n"
+    "  output.beginArray(\"$json_name$\");\n"
+    "  for each (var $element$:$type$ in $member_name$) {\n"
+    "    output.write$text_type$(null, $element$);\n"
+    "  }\n"
+    "  output.endArray();\n"
+    "}\n" },
+  { REPEATED_PRIMITIVE_JSON_PARSING,
+    "for each (var $name$Value:* in JsonReader.parseArray(value)) {\n"
+    "  $member_name$.push(JsonReader.parse$text_type$($name$Value));\n"
+    "}\n" },
+
+  // Enum fields -------------------------------------------------------
+
+  // Enum values are stored as their numbers, -1 when the field is not set.
+  { ENUM_BUILDER_MEMBERS,
+    "public function get$capitalized_name$():$type$ {\n"
+    "  return result.get$capitalized_name$();\n"
+    "}\n"
+    "public function set$capitalized_name$($type$ value):Builder {\n"
+    "  result.has$capitalized_name$ = true;\n"
+    "  result.$name$_ = value;\n"
+    "  return this;\n"
+    "}\n"
+    "public function clear$capitalized_name$():Builder {\n"
+    "  result.has$capitalized_name$ = false;\n"
+    "  result.$name$_ = $default$;\n"
+    "  return this;\n"
+    "}\n" },
+  { ENUM_MERGING,
+    "if (other.has$capitalized_name$()) {\n"
+    "  set$capitalized_name$(other.get$capitalized_name$());\n"
+    "}\n" },
+  { ENUM_PARSING,
+    "$member_name$ = input.readEnum();\n" },
+  { ENUM_SERIALIZATION,
+    "if ($member_name$ != -1) {\n"
+    "  $write_tag$\n"
+    "  output.writeRawVarint32($member_name$);\n"
+    "}\n" },
+  { ENUM_SERIALIZED_SIZE,
+    "if ($member_name$ != -1) {\n"
+    "  size += $tag_size$ + CodedOutputStream.computeRawVarint32Size($member_name$);\n"
+    "}\n" },
+  { ENUM_TEXT_PRINTING,
+    "if ($member_name$ != -1) {\n"
+    "  output.printEnum(\"$text_name$\", $member_name$, $value_names$);\n"
+    "}\n" },
+  { ENUM_TEXT_PARSING,
+    "input.consume(\":\");\n"
+    "$member_name$ = input.consumeEnum($value_names$);\n" },
+  { ENUM_JSON_WRITING,
+    "if ($member_name$ != -1) {\n"
+    "  output.writeEnum(\"$json_name$\", $member_name$, $value_names$);\n"
+    "}\n" },
+  { ENUM_JSON_PARSING,
+    "$member_name$ = JsonReader.parseEnum(value, $value_names$);\n" },
+
+  // Repeated enum fields ----------------------------------------------
+
+  { REPEATED_ENUM_BUILDER_MEMBERS,
+    // Note:  We return an unmodifiable list because otherwise the caller
+    //   could hold on to the returned list and modify it after the message
+    //   has been built, thus mutating the message which is supposed to be
+    //   immutable.
+    "public function get$capitalized_name$List():as3.util.List<$type$> {\n"
+    "  return as3.util.Collections.unmodifiableList(result.$name$_);\n"
+    "}\n"
+    "public function get$capitalized_name$Count():int {\n"
+    "  return result.get$capitalized_name$Count();\n"
+    "}\n"
+    "public function get$capitalized_name$(int index):$type$ {\n"
+    "  return result.get$capitalized_name$(index);\n"
+    "}\n"
+    "public set$capitalized_name$(index:int, value:$type$):Builder {\n"
+    "  result.$name$_.set(index, value);\n"
+    "  return this;\n"
+    "}\n"
+    "public add$capitalized_name$(value:$type$):Builder {\n"
+    "  if (result.$name$_.isEmpty()) {\n"
+    "    result.$name$_ = new as3.util.ArrayList<$type$>();\n"
+    "  }\n"
+    "  result.$name$_.add(value);\n"
+    "  return this;\n"
+    "}\n"
+    "public addAll$capitalized_name$(\n"
+    "    as3.lang.Iterable<? extends $type$> values) {\n"
+    "  if (result.$name$_.isEmpty()):Builder {\n"
+    "    result.$name$_ = new as3.util.ArrayList<$type$>();\n"
+    "  }\n"
+    "  super.addAll(values, result.$name$_);\n"
+    "  return this;\n"
+    "}\n"
+    "public Builder clear$capitalized_name$() {\n"
+    "  result.$name$_ = as3.util.Collections.emptyList();\n"
+    "  return this;\n"
+    "}\n" },
+  { REPEATED_ENUM_MERGING,
+    "if (!other.$name$.isEmpty()) {\n"
+    "  if (result.$name$.isEmpty()) {\n"
+    "    result.$name$ = new Array();\n"
+    "  }\n"
+    "  result.$name$.addAll(other.$name$);\n"
+    "}\n" },
+  { REPEATED_ENUM_BUILDING,
+    "if (result.$name$.length != 0) {\n"
+    "  result.$name$ =\n"
+    "    as3.util.Collections.unmodifiableList(result.$name$_);\n"
+    "}\n" },
+  { REPEATED_ENUM_PARSING,
+    "$member_name$.push(input.readEnum());\n" },
+  { REPEATED_ENUM_SERIALIZATION,
+    "for each (var $name$Element:int in $member_name$) {\n"
+    "  $write_tag$\n"
+    "  output.writeRawVarint32($name$Element);\n"
+    "}\n" },
+  { REPEATED_ENUM_SERIALIZED_SIZE,
+    "for each (var $name$Element:int in $member_name$) {\n"
+    "  size += $tag_size$ + CodedOutputStream.computeRawVarint32Size($name$Element);\n"
+    "}\n" },
+  { REPEATED_ENUM_TEXT_PRINTING,
+    "for each (var $name$Element:int in $member_name$) {\n"
+    "  output.printEnum(\"$text_name$\", $name$Element, $value_names$);\n"
+    "}\n" },
+  { REPEATED_ENUM_TEXT_PARSING,
+    "input.consume(\":\");\n"
+    "$member_name$.push(input.consumeEnum($value_names$));\n" },
+  { REPEATED_ENUM_JSON_WRITING,
+    "if ($member_name$.length > 0) {\n"
+    "  output.beginArray(\"$json_name$\");\n"
+    "  for each (var $name$Element:int in $member_name$) {\n"
+    "    output.writeEnum(null, $name$Element, $value_names$);\n"
+    "  }\n"
+    "  output.endArray();\n"
+    "}\n" },
+  { REPEATED_ENUM_JSON_PARSING,
+    "for each (var $name$Value:* in JsonReader.parseArray(value)) {\n"
+    "  $member_name$.push(JsonReader.parseEnum($name$Value, $value_names$));\n"
+    "}\n" },
+
+  // Message and group fields ------------------------------------------
+
+  // Reading an unset field allocates nothing, it reads as the frozen
+  // default instance.  Mutating it sets a new instance first.
+  { MESSAGE_ACCESSORS,
+    "\n"
+    "/** $name$, or the default instance when it is not set. */\n"
+    "public function get$capitalized_name$():$java_package$$type$ {\n"
+    "  return $name$ != null ? $name$ : $java_package$$type$.getDefaultInstance();\n"
+    "}\n"
+    "\n"
+    "/** $name$, set to a new instance first if it is unset or frozen. */\n"
+    "public function mutable$capitalized_name$():$java_package$$type$ {\n"
+    "  if ($name$ == null || $name$.isFrozen) {\n"
+    "    $name$ = new $java_package$$type$();\n"
+    "  }\n"
+    "  return $name$;\n"
+    "}\n" },
+  // get$capitalized_name$() is one of the members.
+  { MESSAGE_BUILDER_MEMBERS,
+    "public function set$capitalized_name$(value:$type$):$parent$ {\n"
+    "  $name$ = value;\n"
+    "  return this;\n"
+    "}\n"
+    //"public function set$capitalized_name$(builderForValue:$type$.Builder):Builder {\n"
+    //"  result.has$capitalized_name$ = true;\n"
+    //"  result.$name$_ = builderForValue.build();\n"
+    //"  return this;\n"
+    //"}\n"
+    "public function clear$capitalized_name$():$parent$ {\n"
+    "  $name$ = $type$.getDefaultInstance();\n"
+    "  return this;\n"
+    "}\n" },
+  { MESSAGE_MERGING,
+    "if (other.has$capitalized_name$()) {\n"
+    "  merge$capitalized_name$(other.get$capitalized_name$());\n"
+    "}\n" },
+  // A field seen twice on the wire is merged, as required by the spec.
+  { MESSAGE_PARSING,
+    "input.readMessage(mutable$capitalized_name$());\n" },
+  { GROUP_PARSING,
+    "input.readGroup($number$, mutable$capitalized_name$());\n" },
+  // Groups are delimited by their start and end tags instead of a length.
+  { MESSAGE_SERIALIZATION,
+    "if ($member_name$ != null) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "}\n" },
+  { GROUP_SERIALIZATION,
+    "if ($member_name$ != null) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "  $write_end_tag$\n"
+    "}\n" },
+  { MESSAGE_SERIALIZED_SIZE,
+    "if ($member_name$ != null) {\n"
+    "  size += $tag_size$ + $value_size$;\n"
+    "}\n" },
+  { MESSAGE_TEXT_PRINTING,
+    "if ($member_name$ != null) {\n"
+    "  output.printMessage(\"$text_name$\", $member_name$);\n"
+    "}\n" },
+  { MESSAGE_TEXT_PARSING,
+    "input.consumeMessage(mutable$capitalized_name$());\n" },
+  { MESSAGE_JSON_WRITING,
+    "if ($member_name$ != null) {\n"
+    "  output.writeMessage(\"$json_name$\", $member_name$);\n"
+    "}\n" },
+  { MESSAGE_JSON_PARSING,
+    "mutable$capitalized_name$().fromJSONObject(value);\n" },
+
+  // Repeated message and group fields ---------------------------------
+
+  { REPEATED_MESSAGE_BUILDER_MEMBERS,
+    "public function get$capitalized_name$List():Array {\n"
+    "  return $name$;\n"
+    "}\n"
+    "public function get$capitalized_name$Count():int {\n"
+    "  return $name$.length;\n"
+    "}\n"
+    "public function get$capitalized_name$(index:int):$type$ {\n"
+    "  return $name$[index];\n"
+    "}\n"
+    "public function set$capitalized_name$(index:int, value:$type$):$parent$ {\n"
+    "  $name$[index] = value;\n"
+    "  return this;\n"
+    "}\n"
+    "public function add$capitalized_name$(value:$type$):$parent$ {\n"
+    //"  if ($name$_.isEmpty()) {\n"
+    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
+    //"  }\n"
+    "  $name$.push(value);\n"
+    "  return this;\n"
+    "}\n"
+    "public function addAll$capitalized_name$(values:Array):$parent$ {\n"
+    //"  if ($name$_.isEmpty()) {\n"
+    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
+    //"  }\n"
+    "  $name$.concat(values);\n"
+    "  return this;\n"
+    "}\n"
+    "public function clear$capitalized_name$():$parent$  {\n"
+    "  $name$ = new Array();\n"
+    "  return this;\n"
+    "}\n" },
+  { REPEATED_MESSAGE_PARSING,
+    "$member_name$.push(input.readMessage(new $java_package$$type$()));\n" },
+  { REPEATED_GROUP_PARSING,
+    "$member_name$.push(input.readGroup($number$, new $java_package$$type$()));\n" },
+  { REPEATED_MESSAGE_SERIALIZATION,
+    "for each (var $element$:$java_package$$type$ in $member_name$) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "}\n" },
+  { REPEATED_GROUP_SERIALIZATION,
+    "for each (var $element$:$java_package$$type$ in $member_name$) {\n"
+    "  $write_tag$\n"
+    "  $write_value$\n"
+    "  $write_end_tag$\n"
+    "}\n" },
+  { REPEATED_MESSAGE_SERIALIZED_SIZE,
+    "for each (var $element$:$java_package$$type$ in $member_name$) {\n"
+    "  size += $tag_size$ + $value_size$;\n"
+    "}\n" },
+  { REPEATED_MESSAGE_TEXT_PRINTING,
+    "for each (var $element$:$java_package$$type$ in $member_name$) {\n"
+    "  output.printMessage(\"$text_name$\", $element$);\n"
+    "}\n" },
+  { REPEATED_MESSAGE_TEXT_PARSING,
+    "$member_name$.push(input.consumeMessage(new $java_package$$type$()));\n" },
+  { REPEATED_MESSAGE_JSON_WRITING,
+    "if ($member_name$.length > 0) {\n"
+    "  output.beginArray(\"$json_name$\");\n"
+    "  for each (var $element$:$java_package$$type$ in $member_name$) {\n"
+    "    output.writeMessage(null, $element$);\n"
+    "  }\n"
+    "  output.endArray();\n"
+    "}\n" },
+  { REPEATED_MESSAGE_JSON_PARSING,
+    "for each (var $name$Value:Object in JsonReader.parseArray(value)) {\n"
+    "  var $element$:$java_package$$type$ = new $java_package$$type$();\n"
+    "  $element$.fromJSONObject($name$Value);\n"
+    "  $member_name$.push($element$);\n"
+    "}\n" },
+};
+
+const Template* templates[FIELD_TEMPLATE_COUNT];
+GOOGLE_PROTOBUF_DECLARE_ONCE(templates_once);
+
+void ParseTemplates() {
+  GOOGLE_CHECK_EQ(sizeof(kSlotNames) / sizeof(kSlotNames[0]),
+                  FIELD_SLOT_COUNT);
+  for (size_t i = 0; i < sizeof(kTemplates) / sizeof(kTemplates[0]); i++) {
+    const TemplateText& text = kTemplates[i];
+    GOOGLE_CHECK(templates[text.id] == NULL) << " Template defined twice.";
+    templates[text.id] = new Template(text.text, kSlotNames, FIELD_SLOT_COUNT);
+  }
+  for (int i = 0; i < FIELD_TEMPLATE_COUNT; i++) {
+    GOOGLE_CHECK(templates[i] != NULL) << " Undefined template: " << i;
+  }
+}
+
+}  // namespace
+
+const Template& GetFieldTemplate(FieldTemplate id) {
+  // The templates live as long as the process, like protoc's descriptors.
+  GoogleOnceInit(&templates_once, &ParseTemplates);
+  return *templates[id];
+}
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,168 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The templates of the code printed for every field, in one place: the
+// members, the codecs generated for SPEED and LITE_RUNTIME messages, the
+// field registrations and FieldTable rows of CODE_SIZE ones, and the text
+// format and JSON methods.  They are parsed once per process and rendered by
+// the field generators with the values of their field, see FieldGenerator.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_AS3_FIELD_TEMPLATES_H__
+#define GOOGLE_PROTOBUF_COMPILER_AS3_FIELD_TEMPLATES_H__
+
+#include <google/protobuf/compiler/as3/as3_template.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+// The slots of the field templates, named like the variables the field
+// generators used to print with, e.g. SLOT_NAME is "$name$".
+enum FieldSlot {
+  // Set for every field, by FieldGenerator.
+  SLOT_NAME,
+  SLOT_CAPITALIZED_NAME,
+  SLOT_NUMBER,
+  SLOT_TEXT_NAME,
+  SLOT_JSON_NAME,
+  SLOT_PARENT,
+  SLOT_TAG,
+  SLOT_TAG_SIZE,
+  SLOT_WRITE_TAG,
+  SLOT_WRITE_END_TAG,       // Groups only.
+  SLOT_DESCRIPTOR_TYPE,     // e.g. "INT32", the Descriptor constants.
+  SLOT_DESCRIPTOR_LABEL,    // e.g. "OPTIONAL".
+  SLOT_MESSAGE_CLASS,       // The registered class, "null" but for messages.
+  SLOT_TABLE_CLASS,         // The FieldTable class or enum value names.
+  SLOT_TABLE_SLOT,          // The FieldTable slot, see FieldMetadata::slot.
+
+  // Set by the generators of each type of field.
+  SLOT_TYPE,
+  SLOT_BOXED_TYPE,
+  SLOT_DEFAULT,
+  SLOT_CAPITALIZED_TYPE,
+  SLOT_TEXT_TYPE,
+  SLOT_JAVA_PACKAGE,
+  SLOT_VALUE_NAMES,
+  SLOT_ELEMENT,             // The loop variable of repeated fields.
+  SLOT_WRITE_VALUE,
+  SLOT_VALUE_SIZE,
+  SLOT_FIXED_SIZE,          // Empty when the size depends on the value.
+  SLOT_MEMBER_TYPE,         // The type of the member holding the field.
+  SLOT_MEMBER_DEFAULT,      // Its initial value.
+  SLOT_MEMBER_NAME,         // The private member of SPEED and LITE messages.
+
+  FIELD_SLOT_COUNT
+};
+
+enum FieldTemplate {
+  // Every field, printed by MessageGenerator.
+  REGISTER_FIELD,
+  FIELD_TABLE_ROW,
+  FIELD_TABLE_NAME,
+  FIELD_TABLE_TEXT_NAME,
+  FIELD_TABLE_JSON_NAME,
+  FIELD_TABLE_CLASS,
+  FIELD_TABLE_DEFAULT,
+  TABLE_MEMBERS,
+  MEMBERS,
+
+  PRIMITIVE_BUILDER_MEMBERS,
+  PRIMITIVE_MERGING,
+  PRIMITIVE_PARSING,
+  PRIMITIVE_SERIALIZATION,
+  NULLABLE_PRIMITIVE_SERIALIZATION,
+  FIXED_PRIMITIVE_SERIALIZED_SIZE,
+  PRIMITIVE_SERIALIZED_SIZE,
+  NULLABLE_PRIMITIVE_SERIALIZED_SIZE,
+  PRIMITIVE_TEXT_PRINTING,
+  NULLABLE_PRIMITIVE_TEXT_PRINTING,
+  PRIMITIVE_TEXT_PARSING,
+  PRIMITIVE_JSON_WRITING,
+  NULLABLE_PRIMITIVE_JSON_WRITING,
+  PRIMITIVE_JSON_PARSING,
+
+  REPEATED_PRIMITIVE_BUILDER_MEMBERS,
+  REPEATED_PRIMITIVE_MERGING,
+  REPEATED_PRIMITIVE_BUILDING,
+  REPEATED_PRIMITIVE_PARSING,
+  REPEATED_PRIMITIVE_SERIALIZATION,
+  FIXED_REPEATED_PRIMITIVE_SERIALIZED_SIZE,
+  REPEATED_PRIMITIVE_SERIALIZED_SIZE,
+  REPEATED_PRIMITIVE_TEXT_PRINTING,
+  REPEATED_PRIMITIVE_TEXT_PARSING,
+  REPEATED_PRIMITIVE_JSON_WRITING,
+  REPEATED_PRIMITIVE_JSON_PARSING,
+
+  ENUM_BUILDER_MEMBERS,
+  ENUM_MERGING,
+  ENUM_PARSING,
+  ENUM_SERIALIZATION,
+  ENUM_SERIALIZED_SIZE,
+  ENUM_TEXT_PRINTING,
+  ENUM_TEXT_PARSING,
+  ENUM_JSON_WRITING,
+  ENUM_JSON_PARSING,
+
+  REPEATED_ENUM_BUILDER_MEMBERS,
+  REPEATED_ENUM_MERGING,
+  REPEATED_ENUM_BUILDING,
+  REPEATED_ENUM_PARSING,
+  REPEATED_ENUM_SERIALIZATION,
+  REPEATED_ENUM_SERIALIZED_SIZE,
+  REPEATED_ENUM_TEXT_PRINTING,
+  REPEATED_ENUM_TEXT_PARSING,
+  REPEATED_ENUM_JSON_WRITING,
+  REPEATED_ENUM_JSON_PARSING,
+
+  MESSAGE_ACCESSORS,
+  MESSAGE_BUILDER_MEMBERS,
+  MESSAGE_MERGING,
+  MESSAGE_PARSING,
+  GROUP_PARSING,
+  MESSAGE_SERIALIZATION,
+  GROUP_SERIALIZATION,
+  MESSAGE_SERIALIZED_SIZE,
+  MESSAGE_TEXT_PRINTING,
+  MESSAGE_TEXT_PARSING,
+  MESSAGE_JSON_WRITING,
+  MESSAGE_JSON_PARSING,
+
+  REPEATED_MESSAGE_BUILDER_MEMBERS,
+  REPEATED_MESSAGE_PARSING,
+  REPEATED_GROUP_PARSING,
+  REPEATED_MESSAGE_SERIALIZATION,
+  REPEATED_GROUP_SERIALIZATION,
+  REPEATED_MESSAGE_SERIALIZED_SIZE,
+  REPEATED_MESSAGE_TEXT_PRINTING,
+  REPEATED_MESSAGE_TEXT_PARSING,
+  REPEATED_MESSAGE_JSON_WRITING,
+  REPEATED_MESSAGE_JSON_PARSING,
+
+  FIELD_TEMPLATE_COUNT
+};
+
+// Returns the parsed template, whose slots are the FieldSlots.  Safe to call
+// from the threads rendering files concurrently.
+const Template& GetFieldTemplate(FieldTemplate id);
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_AS3_FIELD_TEMPLATES_H__
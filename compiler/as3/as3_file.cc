@@ -18,15 +18,18 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
+#include <set>
+
 #include <google/protobuf/compiler/as3/as3_file.h>
 #include <google/protobuf/compiler/as3/as3_enum.h>
 #include <google/protobuf/compiler/as3/as3_service.h>
 #include <google/protobuf/compiler/as3/as3_extension.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
 #include <google/protobuf/compiler/as3/as3_message.h>
-#include <google/protobuf/compiler/code_generator.h>
+#include <google/protobuf/compiler/as3/as3_metadata.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/stubs/strutil.h>
 
@@ -35,127 +38,230 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
-FileGenerator::FileGenerator(const FileDescriptor* file)
+namespace {
+
+void CollectExtensions(const Descriptor* descriptor,
+                       vector<const FieldDescriptor*>* extensions) {
+  for (int i = 0; i < descriptor->extension_count(); i++) {
+    extensions->push_back(descriptor->extension(i));
+  }
+  for (int i = 0; i < descriptor->nested_type_count(); i++) {
+    CollectExtensions(descriptor->nested_type(i), extensions);
+  }
+}
+
+// Adds the names of the message and its nested messages to the set, and
+// returns the first one which already was in it, or NULL.
+const Descriptor* FindDuplicateClassName(const Descriptor* descriptor,
+                                         set<string>* class_names) {
+  if (!class_names->insert(descriptor->name()).second) return descriptor;
+  for (int i = 0; i < descriptor->nested_type_count(); i++) {
+    const Descriptor* duplicate =
+      FindDuplicateClassName(descriptor->nested_type(i), class_names);
+    if (duplicate != NULL) return duplicate;
+  }
+  return NULL;
+}
+
+}  // namespace
+
+FileGenerator::FileGenerator(const FileDescriptor* file,
+                             const GeneratorOptions& options)
   : file_(file),
+    options_(options),
     as3_package_(FileAs3Package(file)),
-    classname_(FileClassName(file)) {}
+    classname_(FileClassName(file)) {
+  for (int i = 0; i < file_->extension_count(); i++) {
+    extensions_.push_back(file_->extension(i));
+  }
+  for (int i = 0; i < file_->message_type_count(); i++) {
+    CollectExtensions(file_->message_type(i), &extensions_);
+  }
+}
 
 FileGenerator::~FileGenerator() {}
 
 bool FileGenerator::Validate(string* error) {
+  // Every class is written to the package directory under its own name, so
+  // two messages nested in different scopes may not share a name.
+  set<string> class_names;
+  const Descriptor* duplicate = NULL;
+  for (int i = 0; i < file_->message_type_count() && duplicate == NULL; i++) {
+    duplicate = FindDuplicateClassName(file_->message_type(i), &class_names);
+  }
+  if (duplicate != NULL) {
+    error->assign(file_->name());
+    error->append(": Cannot generate As3 output because more than one message "
+                  "is named \"");
+    error->append(duplicate->name());
+    error->append("\", and each is written to its own file in the package.");
+    return false;
+  }
+
   // Check that no class name matches the file's class name.  This is a common
   // problem that leads to As3 compile errors that can be hard to understand.
-  // It's especially bad when using the java_multiple_files, since we would
-  // end up overwriting the outer class with one of the inner ones.
-
-  //bool found_conflict = false;
-  //for (int i = 0; i < file_->enum_type_count() && !found_conflict; i++) {
-  //  if (file_->enum_type(i)->name() == classname_) {
-  //    found_conflict = true;
-  //  }
-  //}
-  //for (int i = 0; i < file_->message_type_count() && !found_conflict; i++) {
-  //  if (file_->message_type(i)->name() == classname_) {
-  //    found_conflict = true;
-  //  }
-  //}
-  //for (int i = 0; i < file_->service_count() && !found_conflict; i++) {
-  //  if (file_->service(i)->name() == classname_) {
-  //    found_conflict = true;
-  //  }
-  //}
-
-  //if (found_conflict) {
-  //  error->assign(file_->name());
-  //  error->append(
-  //    ": Cannot generate As3 output because the file's outer class name, \"");
-  //  error->append(classname_);
-  //  error->append(
-  //    "\", matches the name of one of the types declared inside it.  "
-  //    "Please either rename the type or use the as3_outer_classname "
-  //    "option to specify a different outer class name for the .proto file.");
-  //  return false;
-  //}
+  // The file's class only exists to hold its extensions.
+  if (extensions_.empty()) return true;
+
+  bool found_conflict = false;
+  for (int i = 0; i < file_->enum_type_count() && !found_conflict; i++) {
+    if (file_->enum_type(i)->name() == classname_) {
+      found_conflict = true;
+    }
+  }
+  for (int i = 0; i < file_->message_type_count() && !found_conflict; i++) {
+    if (file_->message_type(i)->name() == classname_) {
+      found_conflict = true;
+    }
+  }
+  for (int i = 0; i < file_->service_count() && !found_conflict; i++) {
+    if (file_->service(i)->name() == classname_) {
+      found_conflict = true;
+    }
+  }
+
+  if (found_conflict) {
+    error->assign(file_->name());
+    error->append(
+      ": Cannot generate As3 output because the file's outer class name, \"");
+    error->append(classname_);
+    error->append(
+      "\", matches the name of one of the types declared inside it.  "
+      "Please either rename the type or use the java_outer_classname "
+      "option to specify a different outer class name for the .proto file.");
+    return false;
+  }
 
   return true;
 }
 
-void FileGenerator::Generate(io::Printer* printer,int message_number) {
-  // We don't import anything because we refer to all classes by their
-  // fully-qualified names in the generated source.
-  
-	
-	printer->Print("// Generated by the protocol buffer compiler.  DO NOT EDIT!\n"
-				   "\n");
-	printer->Print("package $package$ {\n"
-				   "\n",
-				   "package", as3_package_);
-	printer->Indent();
-
-	MessageGenerator(file_->message_type(message_number)).Generate(printer);
-	
-	printer->Outdent();
-	printer->Print("\n}");
+OutputFile::OutputFile(const string& filename, const string& as3_package)
+  : filename_(filename),
+    as3_package_(as3_package) {}
+
+OutputFile::~OutputFile() {}
+
+void OutputFile::Render() {
+  content_.clear();
+  io::StringOutputStream output(&content_);
+  io::Printer printer(&output, '$');
+
+  printer.Print("// Generated by the protocol buffer compiler.  DO NOT EDIT!\n"
+                "\n");
+  printer.Print("package $package$ {\n"
+                "\n",
+                "package", as3_package_);
+  printer.Indent();
+
+  Generate(&printer);
+
+  printer.Outdent();
+  printer.Print("\n}");
 }
 
+namespace {
+
+// A file holding one message, enum or service type, named after it.
 template<typename GeneratorClass, typename DescriptorClass>
-static void GenerateSibling(const string& package_dir,
-                            const string& as3_package,
-                            const DescriptorClass* descriptor,
-                            OutputDirectory* output_directory,
-                            vector<string>* file_list) {
-  string filename = package_dir + descriptor->name() + ".as";
-  file_list->push_back(filename);
-
-  scoped_ptr<io::ZeroCopyOutputStream> output(
-    output_directory->Open(filename));
-  io::Printer printer(output.get(), '$');
-	
-	printer.Print("// Generated by the protocol buffer compiler.  DO NOT EDIT!\n"
-				   "\n");
-	printer.Print("package $package$ {\n"
-				   "\n",
-				   "package", as3_package);
-	printer.Indent();
-	
-	GeneratorClass(descriptor).Generate(&printer);
-	
-	printer.Outdent();
-	printer.Print("\n}");
+class TypeFile : public OutputFile {
+ public:
+  TypeFile(const string& package_dir, const string& as3_package,
+           const DescriptorClass* descriptor, const GeneratorOptions& options)
+    : OutputFile(package_dir + descriptor->name() + ".as", as3_package),
+      descriptor_(descriptor),
+      options_(options) {}
+
+ protected:
+  void Generate(io::Printer* printer) {
+    GeneratorClass(descriptor_, options_).Generate(printer);
+  }
+
+ private:
+  const DescriptorClass* descriptor_;
+  const GeneratorOptions& options_;
+};
+
+class ExtensionsFile : public OutputFile {
+ public:
+  ExtensionsFile(const string& package_dir, FileGenerator* file_generator)
+    : OutputFile(package_dir + file_generator->classname() + ".as",
+                 file_generator->as3_package()),
+      file_generator_(file_generator) {}
+
+ protected:
+  void Generate(io::Printer* printer) {
+    file_generator_->GenerateExtensionsClass(printer);
+  }
+
+ private:
+  FileGenerator* file_generator_;
+};
+
+}  // namespace
+
+void FileGenerator::ListFiles(const string& package_dir,
+                              vector<OutputFile*>* files) {
+  for (int i = 0; i < file_->message_type_count(); i++) {
+    files->push_back(new TypeFile<MessageGenerator, Descriptor>(
+      package_dir, as3_package_, file_->message_type(i), options_));
+  }
+  for (int i = 0; i < file_->enum_type_count(); i++) {
+    files->push_back(new TypeFile<EnumGenerator, EnumDescriptor>(
+      package_dir, as3_package_, file_->enum_type(i), options_));
+  }
+  for (int i = 0; i < file_->message_type_count(); i++) {
+    ListNestedFiles(package_dir, file_->message_type(i), files);
+  }
+  for (int i = 0; i < file_->service_count(); i++) {
+    files->push_back(new TypeFile<ServiceGenerator, ServiceDescriptor>(
+      package_dir, as3_package_, file_->service(i), options_));
+  }
+  if (!extensions_.empty()) {
+    files->push_back(new ExtensionsFile(package_dir, this));
+  }
 }
 
-void FileGenerator::GenerateSiblings(const string& package_dir,
-                                     OutputDirectory* output_directory,
-                                     vector<string>* file_list) {
-  //if (file_->options().java_multiple_files()) {
-    for (int i = 0; i < file_->enum_type_count(); i++) {
-      GenerateSibling<EnumGenerator>(package_dir, as3_package_,
-                                     file_->enum_type(i),
-                                     output_directory, file_list);
-    }
-    for (int i = 0; i < file_->message_type_count(); i++) {
-      //GenerateSibling<MessageGenerator>(package_dir, as3_package_,
-//                                        file_->message_type(i),
-//                                        output_directory, file_list);
-		//This is awesomly bad... supports only 3 levels of nesting :( It's got to be changed to a recursive call
-		for (int j = 0; j < file_->message_type(i)->nested_type_count(); j++) {
-			GenerateSibling<MessageGenerator>(package_dir, as3_package_,
-											  file_->message_type(i)->nested_type(j),
-											  output_directory, file_list);
-			for (int k = 0; k < file_->message_type(i)->nested_type(j)->nested_type_count(); k++) {
-				GenerateSibling<MessageGenerator>(package_dir, as3_package_,
-												  file_->message_type(i)->nested_type(j)->nested_type(k),
-												  output_directory, file_list);
-			}
-			
-		}
-    }
-    for (int i = 0; i < file_->service_count(); i++) {
-      GenerateSibling<ServiceGenerator>(package_dir, as3_package_,
-                                        file_->service(i),
-                                        output_directory, file_list);
-    }
- // }
+void FileGenerator::ListNestedFiles(const string& package_dir,
+                                    const Descriptor* descriptor,
+                                    vector<OutputFile*>* files) {
+  // Nested messages become package level classes, at any depth.
+  for (int i = 0; i < descriptor->nested_type_count(); i++) {
+    files->push_back(new TypeFile<MessageGenerator, Descriptor>(
+      package_dir, as3_package_, descriptor->nested_type(i), options_));
+    ListNestedFiles(package_dir, descriptor->nested_type(i), files);
+  }
+}
+
+void FileGenerator::GenerateExtensionsClass(io::Printer* printer) {
+  printer->Print(
+    "import com.google.protobuf.*;\n"
+    "public final class $classname$ {\n",
+    "classname", classname_);
+  printer->Indent();
+
+  for (int i = 0; i < file_->extension_count(); i++) {
+    const FieldDescriptor* extension = file_->extension(i);
+    ExtensionGenerator(extension, FieldMetadata(extension)).Generate(printer);
+    printer->Print("\n");
+  }
+
+  // Generated extensions only add themselves to the generated registry
+  // once their class is used, this adds them all up front.
+  printer->Print(
+    "/** Adds all the extensions of $filename$ to the registry. */\n"
+    "public static function registerAllExtensions(\n"
+    "    registry:ExtensionRegistry):void {\n",
+    "filename", file_->name());
+  printer->Indent();
+  for (size_t i = 0; i < extensions_.size(); i++) {
+    ExtensionGenerator(extensions_[i], FieldMetadata(extensions_[i]))
+      .GenerateRegistrationCode(printer);
+  }
+  printer->Outdent();
+  printer->Print("}\n");
+
+  printer->Outdent();
+  printer->Print("}\n");
 }
 
 }  // namespace as3
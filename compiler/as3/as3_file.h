@@ -24,25 +24,52 @@
 #include <string>
 #include <vector>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/compiler/as3/as3_options.h>
 
 namespace google {
 namespace protobuf {
   class FileDescriptor;        // descriptor.h
+  class Descriptor;            // descriptor.h
+  class FieldDescriptor;       // descriptor.h
   namespace io {
     class Printer;             // printer.h
   }
-  namespace compiler {
-    class OutputDirectory;     // code_generator.h
-  }
 }
 
 namespace protobuf {
 namespace compiler {
 namespace as3 {
 
+// One generated .as file.  Files only depend on the descriptors, so they can
+// be rendered in any order, concurrently, before being written out.
+class OutputFile {
+ public:
+  OutputFile(const string& filename, const string& as3_package);
+  virtual ~OutputFile();
+
+  const string& filename() const { return filename_; }
+
+  // The source, once Render() was called.
+  const string& content() const { return content_; }
+
+  // Prints the file, package block included, into content().
+  void Render();
+
+ protected:
+  // Prints the body of the package block.
+  virtual void Generate(io::Printer* printer) = 0;
+
+ private:
+  string filename_;
+  string as3_package_;
+  string content_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(OutputFile);
+};
+
 class FileGenerator {
  public:
-  explicit FileGenerator(const FileDescriptor* file);
+  FileGenerator(const FileDescriptor* file, const GeneratorOptions& options);
   ~FileGenerator();
 
   // Checks for problems that would otherwise lead to cryptic compile errors.
@@ -50,23 +77,32 @@ class FileGenerator {
   // the given string and returns false otherwise.
   bool Validate(string* error);
 
-  void Generate(io::Printer* printer,int message_number);
+  // Adds the files of the .proto file to the list, not rendered yet: one
+  // for each message, at any depth, enum and service type, plus the file's
+  // class when it declares extensions.  Each descriptor is visited once.
+  // The caller takes ownership of the files.
+  void ListFiles(const string& package_dir, vector<OutputFile*>* files);
 
-  // If we aren't putting everything into one file, this will write all the
-  // files other than the outer file (i.e. one for each message, enum, and
-  // service type).
-  void GenerateSiblings(const string& package_dir,
-                        OutputDirectory* output_directory,
-                        vector<string>* file_list);
+  // Prints the class named after the file, holding the file scope
+  // extensions and registerAllExtensions().
+  void GenerateExtensionsClass(io::Printer* printer);
 
   const string& as3_package() { return as3_package_; }
   const string& classname()    { return classname_;    }
 
  private:
+  void ListNestedFiles(const string& package_dir,
+                       const Descriptor* descriptor,
+                       vector<OutputFile*>* files);
+
   const FileDescriptor* file_;
+  const GeneratorOptions& options_;
   string as3_package_;
   string classname_;
 
+  // All the extensions declared in the file, nested ones included.
+  vector<const FieldDescriptor*> extensions_;
+
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(FileGenerator);
 };
 
@@ -0,0 +1,224 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reference implementation of the compressed framing of the As3 runtime
+// (com.google.protobuf.CompressedFrames), to produce and check compressed
+// corpora on the server side.  Reads stdin, writes stdout:
+//
+//   as3frames compress [threshold]  varint delimited messages to frames,
+//                                   compressing payloads of at least
+//                                   threshold bytes (default 1024)
+//   as3frames decompress            frames back to varint delimited messages
+//   as3frames verify                checks every frame holds a well formed
+//                                   message
+//
+// A frame is a varint header, (payload size << 1) | compressed, followed by
+// the payload, zlib compressed when the low bit is set.  With --message the
+// input or output is a single message instead, whose frame is one flag byte,
+// 0 or 1, followed by the payload.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/unknown_field_set.h>
+
+using namespace std;
+using namespace google::protobuf;
+using google::protobuf::io::ArrayInputStream;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::io::FileInputStream;
+using google::protobuf::io::FileOutputStream;
+using google::protobuf::io::GzipInputStream;
+using google::protobuf::io::GzipOutputStream;
+using google::protobuf::io::StringOutputStream;
+
+namespace {
+
+const size_t kDefaultThreshold = 1024;
+
+bool Compress(const string& payload, string* output) {
+  StringOutputStream string_output(output);
+  GzipOutputStream::Options options;
+  options.format = GzipOutputStream::ZLIB;
+  GzipOutputStream zlib_output(&string_output, options);
+  void* buffer;
+  int size;
+  size_t done = 0;
+  while (done < payload.size()) {
+    if (!zlib_output.Next(&buffer, &size)) return false;
+    int chunk = static_cast<int>(
+        min(static_cast<size_t>(size), payload.size() - done));
+    memcpy(buffer, payload.data() + done, chunk);
+    done += chunk;
+    if (chunk < size) zlib_output.BackUp(size - chunk);
+  }
+  return zlib_output.Close();
+}
+
+bool Decompress(const string& payload, string* output) {
+  ArrayInputStream array_input(payload.data(), payload.size());
+  GzipInputStream zlib_input(&array_input, GzipInputStream::ZLIB);
+  const void* buffer;
+  int size;
+  while (zlib_input.Next(&buffer, &size)) {
+    output->append(static_cast<const char*>(buffer), size);
+  }
+  return zlib_input.ZlibErrorCode() >= 0;
+}
+
+// Reads a payload preceded by its varint size.  Returns false at the end
+// of the input, sets *error when the input is truncated.
+bool ReadDelimited(CodedInputStream* input, uint32* header, string* payload,
+                   bool is_frame, bool* error) {
+  if (!input->ReadVarint32(header)) return false;
+  uint32 size = is_frame ? *header >> 1 : *header;
+  payload->clear();
+  if (!input->ReadString(payload, size)) *error = true;
+  return !*error;
+}
+
+bool WriteFrame(CodedOutputStream* output, const string& payload,
+                size_t threshold, bool single) {
+  string compressed;
+  bool compress = payload.size() >= threshold;
+  if (compress) {
+    if (!Compress(payload, &compressed)) return false;
+    // Not worth it when deflate does not help.
+    compress = compressed.size() < payload.size();
+  }
+  const string& data = compress ? compressed : payload;
+  if (single) {
+    output->WriteRaw(compress ? "\1" : "\0", 1);
+  } else {
+    output->WriteVarint32((data.size() << 1) | (compress ? 1 : 0));
+  }
+  output->WriteString(data);
+  return !output->HadError();
+}
+
+bool ReadPayload(bool compressed, const string& data, string* payload) {
+  if (!compressed) {
+    *payload = data;
+    return true;
+  }
+  payload->clear();
+  return Decompress(data, payload);
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s compress [threshold] | decompress | verify [--message]\n"
+          "  Converts between varint delimited messages on stdin and the\n"
+          "  compressed frames of the As3 runtime on stdout.\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) return Usage(argv[0]);
+  string mode = argv[1];
+  size_t threshold = kDefaultThreshold;
+  bool single = false;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--message") == 0) {
+      single = true;
+    } else if (mode == "compress") {
+      threshold = strtoul(argv[i], NULL, 10);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (mode != "compress" && mode != "decompress" && mode != "verify") {
+    return Usage(argv[0]);
+  }
+
+  FileInputStream file_input(STDIN_FILENO);
+  FileOutputStream file_output(STDOUT_FILENO);
+  bool ok = true;
+  int count = 0;
+  {
+    CodedInputStream input(&file_input);
+    input.SetTotalBytesLimit(1 << 30, 1 << 30);
+    CodedOutputStream output(&file_output);
+
+    if (single) {
+      // The whole input is one message, or one frame.
+      string data;
+      const void* buffer;
+      int size;
+      while (input.GetDirectBufferPointer(&buffer, &size)) {
+        data.append(static_cast<const char*>(buffer), size);
+        input.Skip(size);
+      }
+      string payload;
+      if (mode == "compress") {
+        ok = WriteFrame(&output, data, threshold, true);
+      } else if (data.empty() || static_cast<unsigned char>(data[0]) > 1) {
+        ok = false;
+      } else {
+        ok = ReadPayload(data[0] == 1, data.substr(1), &payload);
+        if (ok && mode == "decompress") output.WriteString(payload);
+        if (ok && mode == "verify") {
+          UnknownFieldSet fields;
+          ok = fields.ParseFromString(payload);
+        }
+      }
+      count = 1;
+    } else {
+      uint32 header;
+      string data;
+      bool error = false;
+      while (ok && ReadDelimited(&input, &header, &data,
+                                 mode != "compress", &error)) {
+        count++;
+        if (mode == "compress") {
+          ok = WriteFrame(&output, data, threshold, false);
+          continue;
+        }
+        string payload;
+        ok = ReadPayload((header & 1) != 0, data, &payload);
+        if (ok && mode == "decompress") {
+          output.WriteVarint32(payload.size());
+          output.WriteString(payload);
+        } else if (ok) {
+          UnknownFieldSet fields;
+          ok = fields.ParseFromString(payload);
+        }
+      }
+      ok = ok && !error;
+    }
+    ok = ok && !output.HadError();
+  }
+  file_output.Close();
+
+  if (!ok) {
+    fprintf(stderr, "%s: bad input at message %d.\n", argv[0], count);
+    return 1;
+  }
+  if (mode == "verify") {
+    fprintf(stderr, "%d well formed message(s).\n", count);
+  }
+  return 0;
+}
@@ -18,13 +18,25 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include <google/protobuf/compiler/as3/as3_generator.h>
 #include <google/protobuf/compiler/as3/as3_file.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
+#include <google/protobuf/compiler/as3/as3_options.h>
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
 
 namespace google {
 namespace protobuf {
@@ -55,6 +67,114 @@ void ParseOptions(const string& text, vector<pair<string, string> >* output) {
   }
 }
 
+// Renders the files handed out by next_file, shared by the threads of
+// RenderFiles().
+struct RenderQueue {
+  const vector<OutputFile*>* files;
+  size_t next_file;
+  Mutex mutex;
+};
+
+void* RenderFromQueue(void* arg) {
+  RenderQueue* queue = static_cast<RenderQueue*>(arg);
+  while (true) {
+    size_t i;
+    {
+      MutexLock lock(&queue->mutex);
+      i = queue->next_file++;
+    }
+    if (i >= queue->files->size()) return NULL;
+    (*queue->files)[i]->Render();
+  }
+}
+
+// Renders the files on the given number of threads, the calling one
+// included.  Rendering only reads the descriptors, which may be shared.
+// The stubs have no thread type, so the workers are pthreads; on Windows
+// there are none and the files render serially.
+void RenderFiles(const vector<OutputFile*>& files, int threads) {
+  RenderQueue queue;
+  queue.files = &files;
+  queue.next_file = 0;
+#ifndef _WIN32
+  vector<pthread_t> workers;
+  for (size_t i = 1; i < static_cast<size_t>(threads) && i < files.size();
+       i++) {
+    pthread_t worker;
+    // The calling thread renders whatever the missing workers would have.
+    if (pthread_create(&worker, NULL, &RenderFromQueue, &queue) != 0) break;
+    workers.push_back(worker);
+  }
+#endif
+  RenderFromQueue(&queue);
+#ifndef _WIN32
+  for (size_t i = 0; i < workers.size(); i++) {
+    pthread_join(workers[i], NULL);
+  }
+#endif
+}
+
+// 64-bit FNV-1a hash of a generated file, in hex.
+string ContentHash(const string& content) {
+  uint64 hash = GOOGLE_ULONGLONG(14695981039346656037);
+  for (size_t i = 0; i < content.size(); i++) {
+    hash ^= static_cast<uint8>(content[i]);
+    hash *= GOOGLE_ULONGLONG(1099511628211);
+  }
+  char buffer[kFastToBufferSize];
+  return FastHex64ToBuffer(hash, buffer);
+}
+
+bool ReadFile(const string& path, string* content) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL) return false;
+  char buffer[4096];
+  size_t size;
+  while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content->append(buffer, size);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+// Reads the hashes of the files of the previous run, one "hash filename"
+// line per file.  A missing manifest leaves the map empty.
+void ReadManifest(const string& path, map<string, string>* hashes) {
+  string content;
+  if (!ReadFile(path, &content)) return;
+  vector<string> lines;
+  SplitStringUsing(content, "\n", &lines);
+  for (size_t i = 0; i < lines.size(); i++) {
+    string::size_type space = lines[i].find_first_of(' ');
+    if (space == string::npos) continue;
+    (*hashes)[lines[i].substr(space + 1)] = lines[i].substr(0, space);
+  }
+}
+
+// Whether the file on disk already has the content.  A manifest hash
+// other than the new one means the file changed since the previous run;
+// otherwise the file is read back, since it may have been edited or
+// deleted since.
+bool IsUnchanged(const string& directory, const OutputFile& file,
+                 const string& hash, const map<string, string>& old_hashes) {
+  map<string, string>::const_iterator old_hash =
+    old_hashes.find(file.filename());
+  if (old_hash != old_hashes.end() && old_hash->second != hash) return false;
+  string content;
+  return ReadFile(directory + file.filename(), &content) &&
+         content == file.content();
+}
+
+// The number of processors, for threads=0.
+int ProcessorCount() {
+#ifndef _WIN32
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  if (count > 0) return count;
+#endif
+  return 1;
+}
+
 }  // namespace
 
 As3Generator::As3Generator() {}
@@ -74,23 +194,64 @@ bool As3Generator::Generate(const FileDescriptor* file,
   // per line.
   string output_list_file;
 
+  GeneratorOptions generator_options;
+
+  // Threads rendering the files, see RenderFiles().
+  int threads = 1;
+
+  // In incremental mode, the directory protoc writes to, given again since
+  // the OutputDirectory cannot be read back.  Unchanged files are not
+  // written, which keeps their modification time.
+  string incremental_dir;
+
   for (int i = 0; i < options.size(); i++) {
     if (options[i].first == "output_list_file") {
       output_list_file = options[i].second;
+    } else if (options[i].first == "optimize") {
+      // Overrides the optimize_for option of the .proto files.
+      generator_options.override_optimize_for = true;
+      if (options[i].second == "speed") {
+        generator_options.optimize_for = FileOptions::SPEED;
+      } else if (options[i].second == "code_size") {
+        generator_options.optimize_for = FileOptions::CODE_SIZE;
+      } else if (options[i].second == "lite") {
+        generator_options.optimize_for = FileOptions::LITE_RUNTIME;
+      } else {
+        *error = "Unknown optimize mode: " + options[i].second +
+                 " (expected speed, code_size or lite)";
+        return false;
+      }
+    } else if (options[i].first == "externalizable") {
+      generator_options.externalizable = true;
+    } else if (options[i].first == "threads") {
+      // 0 uses one thread per processor.  Windows builds ignore the
+      // option and render on the calling thread only.
+      char* end;
+      threads = strtol(options[i].second.c_str(), &end, 10);
+      if (options[i].second.empty() || *end != '\0' || threads < 0) {
+        *error = "Invalid thread count: " + options[i].second;
+        return false;
+      }
+      if (threads == 0) threads = ProcessorCount();
+    } else if (options[i].first == "incremental") {
+      incremental_dir = options[i].second;
+      if (incremental_dir.empty()) {
+        *error = "The incremental option needs the output directory, e.g. "
+                 "incremental=out for --as3_out=out.";
+        return false;
+      }
+      if (incremental_dir[incremental_dir.size() - 1] != '/') {
+        incremental_dir += "/";
+      }
     } else {
       *error = "Unknown generator option: " + options[i].first;
       return false;
     }
   }
 
-
   // -----------------------------------------------------------------
-	
-  vector<string> all_files;	
 
-  for (int i = 0; i < file->message_type_count(); i++) {
-
-  FileGenerator file_generator(file);
+  FileGenerator file_generator(file, generator_options);
   if (!file_generator.Validate(error)) {
     return false;
   }
@@ -98,25 +259,56 @@ bool As3Generator::Generate(const FileDescriptor* file,
   string package_dir =
     StringReplace(file_generator.as3_package(), ".", "/", true);
   if (!package_dir.empty()) package_dir += "/";
-  string as3_filename = package_dir;
-  //as3_filename += file_generator.classname();
-  as3_filename += file->message_type(i)->name();
-  as3_filename += ".as";
-  all_files.push_back(as3_filename);
-
-  // Generate main as3 file.
-  scoped_ptr<io::ZeroCopyOutputStream> output(
-    output_directory->Open(as3_filename));
-  io::Printer printer(output.get(), '$');
-
-  file_generator.Generate(&printer,i);
-	  
-  // Generate sibling files.
-  file_generator.GenerateSiblings(package_dir, output_directory, &all_files);
-	  
+
+  // The files are rendered to memory, possibly concurrently, then written
+  // in the order they were listed, so the output does not depend on the
+  // number of threads.
+  vector<OutputFile*> files;
+  file_generator.ListFiles(package_dir, &files);
+
+  RenderFiles(files, threads);
+
+  // The manifest lists the hash of each file, next to the output list.
+  string manifest_file =
+    (output_list_file.empty() ? StripProto(file->name()) + ".as3"
+                              : output_list_file) + ".manifest";
+  map<string, string> old_hashes;
+  if (!incremental_dir.empty()) {
+    ReadManifest(incremental_dir + manifest_file, &old_hashes);
   }
-	  
 
+  vector<string> all_files;
+  string manifest;
+  for (size_t i = 0; i < files.size(); i++) {
+    all_files.push_back(files[i]->filename());
+    if (!incremental_dir.empty()) {
+      string hash = ContentHash(files[i]->content());
+      manifest += hash + " " + files[i]->filename() + "\n";
+      bool unchanged =
+        IsUnchanged(incremental_dir, *files[i], hash, old_hashes);
+      old_hashes.erase(files[i]->filename());
+      if (unchanged) continue;
+    }
+    scoped_ptr<io::ZeroCopyOutputStream> output(
+      output_directory->Open(files[i]->filename()));
+    io::CodedOutputStream(output.get()).WriteString(files[i]->content());
+  }
+  STLDeleteElements(&files);
+
+  if (!incremental_dir.empty()) {
+    // What is left of the previous manifest is no longer generated.  The
+    // files are only reported: everything written goes through the
+    // OutputDirectory, which cannot delete.
+    for (map<string, string>::const_iterator stale = old_hashes.begin();
+         stale != old_hashes.end(); ++stale) {
+      GOOGLE_LOG(WARNING) << incremental_dir << stale->first
+                          << " is no longer generated from " << file->name()
+                          << ".";
+    }
+    scoped_ptr<io::ZeroCopyOutputStream> output(
+      output_directory->Open(manifest_file));
+    io::CodedOutputStream(output.get()).WriteString(manifest);
+  }
 
   // Generate output list if requested.
   if (!output_list_file.empty()) {
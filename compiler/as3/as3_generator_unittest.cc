@@ -0,0 +1,265 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests of the As3 generator: the output of each optimize mode is compared
+// with the golden files in testdata/, which hold every generated file after
+// a "// ---- <filename>" line.  After an intended change of the output,
+// regenerate them by running the tests with AS3_UPDATE_GOLDEN=1 and review
+// the diff.
+
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/compiler/as3/as3_generator.h>
+#include <google/protobuf/compiler/importer.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/substitute.h>
+#include <google/protobuf/testing/file.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+namespace {
+
+const char kTestProto[] =
+  "google/protobuf/compiler/as3/testdata/as3_unittest.proto";
+const char kPackageDir[] = "as3/unittest/";
+const char kManifest[] =
+  "google/protobuf/compiler/as3/testdata/as3_unittest.as3.manifest";
+
+class MockErrorCollector : public MultiFileErrorCollector {
+ public:
+  MockErrorCollector() {}
+  ~MockErrorCollector() {}
+
+  string text_;
+
+  // implements ErrorCollector ---------------------------------------
+  void AddError(const string& filename, int line, int column,
+                const string& message) {
+    strings::SubstituteAndAppend(&text_, "$0:$1:$2: $3\n",
+                                 filename, line, column, message);
+  }
+};
+
+// Keeps the generated files in memory, in the order they were opened.
+class MockOutputDirectory : public OutputDirectory {
+ public:
+  MockOutputDirectory() {}
+  ~MockOutputDirectory() {}
+
+  // implements OutputDirectory --------------------------------------
+  io::ZeroCopyOutputStream* Open(const string& filename) {
+    EXPECT_TRUE(files_.find(filename) == files_.end())
+      << filename << " written twice.";
+    order_.push_back(filename);
+    return new io::StringOutputStream(&files_[filename]);
+  }
+
+  const vector<string>& order() const { return order_; }
+
+  const string& Get(const string& filename) const {
+    map<string, string>::const_iterator file = files_.find(filename);
+    GOOGLE_CHECK(file != files_.end()) << filename << " was not written.";
+    return file->second;
+  }
+
+  // All the files, each after a "// ---- <filename>" line.
+  string Dump() const {
+    string dump;
+    for (size_t i = 0; i < order_.size(); i++) {
+      dump += "// ---- " + order_[i] + "\n";
+      dump += Get(order_[i]) + "\n";
+    }
+    return dump;
+  }
+
+  // Writes the files under the given directory, as protoc would.
+  void WriteTo(const string& directory) const {
+    for (size_t i = 0; i < order_.size(); i++) {
+      string path = directory + "/" + order_[i];
+      ASSERT_TRUE(File::RecursivelyCreateDir(
+        path.substr(0, path.find_last_of('/')), 0777));
+      File::WriteStringToFileOrDie(Get(order_[i]), path);
+    }
+  }
+
+ private:
+  vector<string> order_;
+  map<string, string> files_;
+};
+
+class As3GeneratorTest : public testing::Test {
+ protected:
+  void SetUp() {
+    source_tree_.MapPath("", TestSourceDir());
+    importer_.reset(new Importer(&source_tree_, &error_collector_));
+    file_ = importer_->Import(kTestProto);
+    ASSERT_TRUE(file_ != NULL) << error_collector_.text_;
+  }
+
+  // Generates the test file with the given parameter.
+  void Generate(const string& parameter, MockOutputDirectory* output) {
+    As3Generator generator;
+    string error;
+    ASSERT_TRUE(generator.Generate(file_, parameter, output, &error))
+      << error;
+  }
+
+  void ExpectGolden(const string& parameter, const string& golden) {
+    MockOutputDirectory output;
+    Generate(parameter, &output);
+    string path =
+      TestSourceDir() + "/google/protobuf/compiler/as3/testdata/" + golden;
+    if (getenv("AS3_UPDATE_GOLDEN") != NULL) {
+      File::WriteStringToFileOrDie(output.Dump(), path);
+    }
+    string expected;
+    File::ReadFileToStringOrDie(path, &expected);
+    EXPECT_EQ(expected, output.Dump());
+  }
+
+  DiskSourceTree source_tree_;
+  MockErrorCollector error_collector_;
+  scoped_ptr<Importer> importer_;
+  const FileDescriptor* file_;
+};
+
+TEST_F(As3GeneratorTest, SpeedGolden) {
+  ExpectGolden("optimize=speed", "as3_unittest_speed.golden");
+}
+
+TEST_F(As3GeneratorTest, CodeSizeGolden) {
+  ExpectGolden("optimize=code_size", "as3_unittest_code_size.golden");
+}
+
+TEST_F(As3GeneratorTest, LiteGolden) {
+  ExpectGolden("optimize=lite", "as3_unittest_lite.golden");
+}
+
+TEST_F(As3GeneratorTest, ExternalizableGolden) {
+  ExpectGolden("externalizable", "as3_unittest_externalizable.golden");
+}
+
+TEST_F(As3GeneratorTest, OneClassPerFile) {
+  MockOutputDirectory output;
+  Generate("", &output);
+  ASSERT_EQ(7u, output.order().size());
+  for (size_t i = 0; i < output.order().size(); i++) {
+    const string& filename = output.order()[i];
+    EXPECT_TRUE(HasPrefixString(filename, kPackageDir)) << filename;
+    EXPECT_TRUE(HasSuffixString(filename, ".as")) << filename;
+    const string& content = output.Get(filename);
+    // mxmlc and compc only accept one package block per source.
+    EXPECT_EQ(content.find("package "), content.rfind("package "))
+      << filename;
+  }
+}
+
+TEST_F(As3GeneratorTest, UnknownOptimizeMode) {
+  As3Generator generator;
+  MockOutputDirectory output;
+  string error;
+  EXPECT_FALSE(generator.Generate(file_, "optimize=fast", &output, &error));
+  EXPECT_EQ("Unknown optimize mode: fast (expected speed, code_size or lite)",
+            error);
+}
+
+TEST_F(As3GeneratorTest, ThreadCountDoesNotChangeOutput) {
+  const char* modes[] = { "speed", "code_size", "lite" };
+  for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+    SCOPED_TRACE(modes[i]);
+    MockOutputDirectory serial;
+    Generate(string("optimize=") + modes[i] + ",threads=1", &serial);
+    MockOutputDirectory parallel;
+    Generate(string("optimize=") + modes[i] + ",threads=8", &parallel);
+    EXPECT_TRUE(serial.order() == parallel.order());
+    EXPECT_EQ(serial.Dump(), parallel.Dump());
+  }
+}
+
+TEST_F(As3GeneratorTest, InvalidThreadCount) {
+  As3Generator generator;
+  MockOutputDirectory output;
+  string error;
+  EXPECT_FALSE(generator.Generate(file_, "threads=-1", &output, &error));
+  EXPECT_EQ("Invalid thread count: -1", error);
+}
+
+TEST_F(As3GeneratorTest, IncrementalSkipsUnchangedFiles) {
+  string directory = TestTempDir() + "/as3_incremental";
+  File::DeleteRecursively(directory, NULL, NULL);
+  string parameter = "incremental=" + directory;
+
+  MockOutputDirectory first;
+  Generate(parameter, &first);
+  EXPECT_EQ(8u, first.order().size());  // The classes and the manifest.
+  first.WriteTo(directory);
+
+  // Nothing changed: only the manifest is written again.
+  MockOutputDirectory second;
+  Generate(parameter, &second);
+  ASSERT_EQ(1u, second.order().size());
+  EXPECT_EQ(kManifest, second.order()[0]);
+
+  // A file edited since is compared by content and written again.
+  string item_file = string(kPackageDir) + "Item.as";
+  File::WriteStringToFileOrDie("edited", directory + "/" + item_file);
+  MockOutputDirectory third;
+  Generate(parameter, &third);
+  ASSERT_EQ(2u, third.order().size());
+  EXPECT_EQ(item_file, third.order()[0]);
+  EXPECT_EQ(first.Get(item_file), third.Get(item_file));
+}
+
+TEST_F(As3GeneratorTest, IncrementalReportsStaleFiles) {
+  string directory = TestTempDir() + "/as3_stale";
+  File::DeleteRecursively(directory, NULL, NULL);
+  string parameter = "incremental=" + directory;
+
+  MockOutputDirectory first;
+  Generate(parameter, &first);
+  first.WriteTo(directory);
+  string manifest_path = directory + "/" + kManifest;
+  string manifest;
+  File::ReadFileToStringOrDie(manifest_path, &manifest);
+  File::WriteStringToFileOrDie(manifest + "0 as3/unittest/Gone.as\n",
+                               manifest_path);
+  File::WriteStringToFileOrDie("gone", directory + "/as3/unittest/Gone.as");
+
+  ScopedMemoryLog log;
+  MockOutputDirectory second;
+  Generate(parameter, &second);
+  const vector<string>& warnings = log.GetMessages(LOGLEVEL_WARNING);
+  ASSERT_EQ(1u, warnings.size());
+  EXPECT_NE(string::npos, warnings[0].find("Gone.as is no longer generated"));
+  // Reported only, never deleted.
+  EXPECT_TRUE(File::Exists(directory + "/as3/unittest/Gone.as"));
+}
+
+}  // namespace
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
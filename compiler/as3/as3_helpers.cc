@@ -158,6 +158,12 @@ string ClassName(const FileDescriptor* descriptor) {
   return result;
 }
 
+string QualifiedMessageClassName(const Descriptor* descriptor) {
+  string package = FileAs3Package(descriptor->file());
+  if (package.empty()) return descriptor->name();
+  return package + "." + descriptor->name();
+}
+
 As3Type GetAs3Type(FieldDescriptor::Type field_type) {
   switch (field_type) {
     case FieldDescriptor::TYPE_INT32:
@@ -224,6 +230,141 @@ const char* BoxedPrimitiveTypeName(As3Type type) {
   return NULL;
 }
 
+namespace {
+
+int WireTypeForFieldType(FieldDescriptor::Type type) {
+  switch (type) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_SINT32:
+    case FieldDescriptor::TYPE_SINT64:
+    case FieldDescriptor::TYPE_BOOL:
+    case FieldDescriptor::TYPE_ENUM:
+      return 0;  // WIRETYPE_VARINT
+
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+      return 1;  // WIRETYPE_FIXED64
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES:
+    case FieldDescriptor::TYPE_MESSAGE:
+      return 2;  // WIRETYPE_LENGTH_DELIMITED
+
+    case FieldDescriptor::TYPE_GROUP:
+      return 3;  // WIRETYPE_START_GROUP
+
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_FLOAT:
+      return 5;  // WIRETYPE_FIXED32
+
+    // No default because we want the compiler to complain if any new
+    // types are added.
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return 0;
+}
+
+}  // namespace
+
+uint32 MakeFieldTag(const FieldDescriptor* field) {
+  return (static_cast<uint32>(field->number()) << 3) |
+         WireTypeForFieldType(field->type());
+}
+
+int TagSize(uint32 tag) {
+  int size = 1;
+  while (tag >= 0x80) {
+    tag >>= 7;
+    size++;
+  }
+  return size;
+}
+
+string WriteTagStatement(uint32 tag) {
+  string result;
+  while (true) {
+    if (!result.empty()) result += ' ';
+    if (tag < 0x80) {
+      result += "output.writeRawByte(" + SimpleItoa(tag) + ");";
+      return result;
+    }
+    result += "output.writeRawByte(" + SimpleItoa((tag & 0x7F) | 0x80) + ");";
+    tag >>= 7;
+  }
+}
+
+string TextFieldName(const FieldDescriptor* field) {
+  if (field->type() == FieldDescriptor::TYPE_GROUP) {
+    return field->message_type()->name();
+  }
+  return field->name();
+}
+
+string JsonFieldName(const FieldDescriptor* field) {
+  const string& name = field->name();
+  string result;
+  bool capitalize_next = false;
+  for (size_t i = 0; i < name.size(); i++) {
+    if (name[i] == '_') {
+      capitalize_next = true;
+    } else if (capitalize_next && 'a' <= name[i] && name[i] <= 'z') {
+      result += name[i] + ('A' - 'a');
+      capitalize_next = false;
+    } else {
+      result += name[i];
+      capitalize_next = false;
+    }
+  }
+  return result;
+}
+
+string EnumValueNamesName(const FieldDescriptor* field) {
+  return UnderscoresToCamelCase(field) + "ValueNames";
+}
+
+const char* LabelName(FieldDescriptor::Label label) {
+  switch (label) {
+	case FieldDescriptor::LABEL_OPTIONAL		: return "LABEL_OPTIONAL";
+	case FieldDescriptor::LABEL_REQUIRED		: return "LABEL_REQUIRED";
+	case FieldDescriptor::LABEL_REPEATED		: return "LABEL_REPEATED";
+
+  }		 
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return NULL;
+}
+
+const char* AllCapsTypeName(FieldDescriptor::Type type) {
+  switch (type) {
+
+	case FieldDescriptor::TYPE_DOUBLE	: return "DOUBLE";
+    case FieldDescriptor::TYPE_FLOAT	: return "FLOAT";          
+    case FieldDescriptor::TYPE_INT64    : return "INT64";                       
+    case FieldDescriptor::TYPE_UINT64   : return "UINT64";     
+    case FieldDescriptor::TYPE_INT32    : return "INT32";             
+    case FieldDescriptor::TYPE_FIXED64  : return "FIXED64";
+    case FieldDescriptor::TYPE_FIXED32  : return "FIXED32";
+    case FieldDescriptor::TYPE_BOOL		: return "BOOL";
+    case FieldDescriptor::TYPE_STRING	: return "STRING";
+    case FieldDescriptor::TYPE_GROUP	: return "GROUP";
+    case FieldDescriptor::TYPE_MESSAGE	: return "MESSAGE";
+    case FieldDescriptor::TYPE_BYTES	: return "BYTES";
+    case FieldDescriptor::TYPE_UINT32	: return "UINT32";
+    case FieldDescriptor::TYPE_ENUM		: return "ENUM";
+    case FieldDescriptor::TYPE_SFIXED32	: return "SFIXED32";
+    case FieldDescriptor::TYPE_SFIXED64	: return "SFIXED64";
+    case FieldDescriptor::TYPE_SINT32	: return "SINT32";
+    case FieldDescriptor::TYPE_SINT64	: return "SINT64";
+  }		 
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return NULL;
+}
+
 }  // namespace as3
 }  // namespace compiler
 }  // namespace protobuf
@@ -21,6 +21,7 @@
 #ifndef GOOGLE_PROTOBUF_COMPILER_AS3_HELPERS_H__
 #define GOOGLE_PROTOBUF_COMPILER_AS3_HELPERS_H__
 
+#include <map>
 #include <string>
 #include <google/protobuf/descriptor.h>
 
@@ -71,6 +72,10 @@ inline string ClassName(const ServiceDescriptor* descriptor) {
 }
 string ClassName(const FileDescriptor* descriptor);
 
+// Returns the fully qualified name of the As3 class generated for the
+// message, each message getting its own file in the package of its .proto.
+string QualifiedMessageClassName(const Descriptor* descriptor);
+
 enum As3Type {
   AS3TYPE_INT,
   AS3TYPE_LONG,
@@ -94,6 +99,39 @@ inline As3Type GetAs3Type(const FieldDescriptor* field) {
 // types.
 const char* BoxedPrimitiveTypeName(As3Type type);
 
+// Returns the tag of the field, as written on the wire.  Repeated fields are
+// never packed by the As3 runtime, so the wire type only depends on the
+// field type.
+uint32 MakeFieldTag(const FieldDescriptor* field);
+
+// Returns the number of bytes of the varint encoded tag.
+int TagSize(uint32 tag);
+
+// Returns the As3 statement writing the pre-encoded bytes of the tag to the
+// CodedOutputStream named "output", e.g. "output.writeRawByte(10);".
+string WriteTagStatement(uint32 tag);
+
+// Returns the name of the field in text format.  Groups are named after
+// their type, e.g. "MyGroup", the other fields keep their .proto name.
+string TextFieldName(const FieldDescriptor* field);
+
+// Returns the name of the field in JSON, the lowerCamelCase name protoc
+// derives from the .proto name: underscores are dropped and the letter
+// following each is capitalized, e.g. "foo_bar" is "fooBar" and "value2x"
+// stays "value2x".
+string JsonFieldName(const FieldDescriptor* field);
+
+// Returns the name of the static member which maps the numbers of the
+// values of an enum field to their names, for the text format.
+string EnumValueNamesName(const FieldDescriptor* field);
+
+// Returns the name of the Descriptor constant of the label, e.g.
+// "LABEL_OPTIONAL".
+const char* LabelName(FieldDescriptor::Label label);
+
+// Returns the name of the Descriptor constant of the type, e.g. "INT32".
+const char* AllCapsTypeName(FieldDescriptor::Type type);
+
 }  // namespace as3
 }  // namespace compiler
 }  // namespace protobuf
@@ -19,6 +19,7 @@
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
 #include <algorithm>
+#include <set>
 #include <google/protobuf/stubs/hash.h>
 #include <google/protobuf/compiler/as3/as3_message.h>
 #include <google/protobuf/compiler/as3/as3_enum.h>
@@ -39,58 +40,13 @@ using internal::WireFormat;
 
 namespace {
 
-const char* LabelName(FieldDescriptor::Label label) {
-  switch (label) {
-	case FieldDescriptor::LABEL_OPTIONAL		: return "LABEL_OPTIONAL";
-	case FieldDescriptor::LABEL_REQUIRED		: return "LABEL_REQUIRED";
-	case FieldDescriptor::LABEL_REPEATED		: return "LABEL_REPEATED";
-
-  }		 
-  GOOGLE_LOG(FATAL) << "Can't get here.";
-  return NULL;
-}
-
-const char* AllCapsTypeName(FieldDescriptor::Type type) {
-  switch (type) {
-
-	case FieldDescriptor::TYPE_DOUBLE	: return "DOUBLE";
-    case FieldDescriptor::TYPE_FLOAT	: return "FLOAT";          
-    case FieldDescriptor::TYPE_INT64    : return "INT64";                       
-    case FieldDescriptor::TYPE_UINT64   : return "UINT64";     
-    case FieldDescriptor::TYPE_INT32    : return "INT32";             
-    case FieldDescriptor::TYPE_FIXED64  : return "FIXED64";
-    case FieldDescriptor::TYPE_FIXED32  : return "FIXED32";
-    case FieldDescriptor::TYPE_BOOL		: return "BOOL";
-    case FieldDescriptor::TYPE_STRING	: return "STRING";
-    case FieldDescriptor::TYPE_GROUP	: return "GROUP";
-    case FieldDescriptor::TYPE_MESSAGE	: return "MESSAGE";
-    case FieldDescriptor::TYPE_BYTES	: return "BYTES";
-    case FieldDescriptor::TYPE_UINT32	: return "UINT32";
-    case FieldDescriptor::TYPE_ENUM		: return "ENUM";
-    case FieldDescriptor::TYPE_SFIXED32	: return "SFIXED32";
-    case FieldDescriptor::TYPE_SFIXED64	: return "SFIXED64";
-    case FieldDescriptor::TYPE_SINT32	: return "SINT32";
-    case FieldDescriptor::TYPE_SINT64	: return "SINT64";
-  }		 
-  GOOGLE_LOG(FATAL) << "Can't get here.";
-  return NULL;
-}
-
-void PrintFieldComment(io::Printer* printer, const FieldDescriptor* field) {
-  // Print the field's proto-syntax definition as a comment.  We don't want to
-  // print group bodies so we cut off after the first line.
-  string def = field->DebugString();
+void PrintFieldComment(io::Printer* printer, const FieldMetadata& metadata) {
+  // Print the field's proto-syntax definition as a comment, up to the body
+  // of groups, see FieldMetadata::comment.
   printer->Print("// $def$\n",
-    "def", def.substr(0, def.find_first_of('\n')));
+    "def", metadata.comment);
 }
 
-struct FieldOrderingByNumber {
-  inline bool operator()(const FieldDescriptor* a,
-                         const FieldDescriptor* b) const {
-    return a->number() < b->number();
-  }
-};
-
 struct ExtensionRangeOrdering {
   bool operator()(const Descriptor::ExtensionRange* a,
                   const Descriptor::ExtensionRange* b) const {
@@ -98,26 +54,6 @@ struct ExtensionRangeOrdering {
   }
 };
 
-// Sort the fields of the given Descriptor by number into a new[]'d array
-// and return it.
-const FieldDescriptor** SortFieldsByNumber(const Descriptor* descriptor) {
-  const FieldDescriptor** fields =
-    new const FieldDescriptor*[descriptor->field_count()];
-  for (int i = 0; i < descriptor->field_count(); i++) {
-    fields[i] = descriptor->field(i);
-  }
-  sort(fields, fields + descriptor->field_count(),
-       FieldOrderingByNumber());
-  return fields;
-}
-
-// Get an identifier that uniquely identifies this type within the file.
-// This is used to declare static variables related to this type at the
-// outermost file scope.
-string UniqueFileScopeIdentifier(const Descriptor* descriptor) {
-  return "static_" + StringReplace(descriptor->full_name(), ".", "_", true);
-}
-
 // Returns true if the message type has any required fields.  If it doesn't,
 // we can optimize out calls to its isInitialized() method.
 //
@@ -139,10 +75,21 @@ static bool HasRequiredFields(
   }
   already_seen->insert(type);
 
-  // If the type has extensions, an extension with message type could contain
-  // required fields, so we have to be conservative and assume such an
-  // extension exists.
-  if (type->extension_range_count() > 0) return true;
+  // Rather than assuming an extension with required fields exists, check
+  // the extensions of the type the pool knows, that is those declared in
+  // the file or the files it imports.
+  if (type->extension_range_count() > 0) {
+    vector<const FieldDescriptor*> extensions;
+    type->file()->pool()->FindAllExtensions(type, &extensions);
+    for (size_t i = 0; i < extensions.size(); i++) {
+      const FieldDescriptor* extension = extensions[i];
+      if (extension->is_required()) return true;
+      if (extension->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+          HasRequiredFields(extension->message_type(), already_seen)) {
+        return true;
+      }
+    }
+  }
 
   for (int i = 0; i < type->field_count(); i++) {
     const FieldDescriptor* field = type->field(i);
@@ -168,73 +115,16 @@ static bool HasRequiredFields(const Descriptor* type) {
 
 // ===================================================================
 
-MessageGenerator::MessageGenerator(const Descriptor* descriptor)
+MessageGenerator::MessageGenerator(const Descriptor* descriptor,
+                                   const GeneratorOptions& options)
   : descriptor_(descriptor),
-    field_generators_(descriptor) {
+    options_(options),
+    metadata_(descriptor),
+    field_generators_(descriptor, metadata_) {
 }
 
 MessageGenerator::~MessageGenerator() {}
 
-void MessageGenerator::GenerateStaticVariables(io::Printer* printer) {
-  // Because descriptor.proto (com.google.protobuf.DescriptorProtos) is
-  // used in the construction of descriptors, we have a tricky bootstrapping
-  // problem.  To help control static initialization order, we make sure all
-  // descriptors and other static data that depends on them are members of
-  // the outermost class in the file.  This way, they will be initialized in
-  // a deterministic order.
-
-  map<string, string> vars;
-  vars["identifier"] = UniqueFileScopeIdentifier(descriptor_);
-  vars["index"] = SimpleItoa(descriptor_->index());
-  vars["classname"] = ClassName(descriptor_);
-  if (descriptor_->containing_type() != NULL) {
-    vars["parent"] = UniqueFileScopeIdentifier(descriptor_->containing_type());
-  }
-  if (descriptor_->file()->options().java_multiple_files()) {
-    // We can only make these package-private since the classes that use them
-    // are in separate files.
-    vars["private"] = "";
-  } else {
-    vars["private"] = "private ";
-  }
-
-  // The descriptor for this type.
-  if (descriptor_->containing_type() == NULL) {
-    printer->Print(vars,
-	  "$private$static final internal_$identifier$_descriptor:com.google.protobuf.Descriptors.Descriptor =\n"
-      "    getDescriptor().getMessageTypes().get($index$);\n");
-  } else {
-    printer->Print(vars,
-		"$private$static final internal_$identifier$_descriptor:com.google.protobuf.Descriptors.Descriptor =\n"
-      "    internal_$parent$_descriptor.getNestedTypes().get($index$);\n");
-  }
-
-  // And the FieldAccessorTable.
-  printer->Print(vars,
-    "$private$static\n"
-	"    internal_$identifier$_fieldAccessorTable:com.google.protobuf.GeneratedMessage.FieldAccessorTable = new\n"
-    "      com.google.protobuf.GeneratedMessage.FieldAccessorTable(\n"
-    "        internal_$identifier$_descriptor,\n"
-    "        new String[] { ");
-  for (int i = 0; i < descriptor_->field_count(); i++) {
-    printer->Print(
-      "\"$field_name$\", ",
-      "field_name",
-        UnderscoresToCapitalizedCamelCase(descriptor_->field(i)));
-  }
-  printer->Print("},\n"
-    "        $classname$.class,\n"
-    "        $classname$.Builder.class);\n",
-    "classname", ClassName(descriptor_));
-
-  // Generate static members for all nested types.
-  for (int i = 0; i < descriptor_->nested_type_count(); i++) {
-    // TODO(kenton):  Reuse MessageGenerator objects?
-    MessageGenerator(descriptor_->nested_type(i))
-      .GenerateStaticVariables(printer);
-  }
-}
-
 void MessageGenerator::Generate(io::Printer* printer) {
   bool is_own_file =
     descriptor_->containing_type() == NULL &&
@@ -245,6 +135,8 @@ void MessageGenerator::Generate(io::Printer* printer) {
 	printer->Print("import flash.utils.*;\n");
 	printer->Print("import com.hurlant.math.BigInteger;\n");
 	
+	// Once per message type, however many fields have it.
+	set<string> imported;
 	for (int i = 0; i < descriptor_->field_count(); i++) {
 		if (descriptor_->field(i)->type() == FieldDescriptor::TYPE_MESSAGE) {
 			
@@ -252,56 +144,68 @@ void MessageGenerator::Generate(io::Printer* printer) {
 		  if(!p.empty()) {
 		    p = p.append(".");
 		  }		
+		  string messagetype = descriptor_->field(i)->message_type()->name();
+		  if (!imported.insert(p + messagetype).second) continue;
 		  printer->Print("import $package$$messagetype$;\n"
 		  				,"package", p
-						,"messagetype", descriptor_->field(i)->message_type()->name());	
+						,"messagetype", messagetype);	
 		}
 	}
 	
-	printer->Print("public final class $classname$ extends Message {\n",
-				   "classname", descriptor_->name());
+	if (options_.externalizable) {
+	  printer->Print("import flash.net.registerClassAlias;\n");
+	}
+	
+	printer->Print("public final class $classname$ extends Message$implements$ {\n",
+				   "classname", descriptor_->name(),
+				   "implements", options_.externalizable ? " implements IExternalizable" : "");
   
 	printer->Indent();
-			
-	printer->Print("public function $classname$() {\n",
-				   "classname", descriptor_->name());
 
-  printer->Indent();
-  for (int i = 0; i < descriptor_->field_count(); i++) {
-	  printer->Print("registerField(\"$name$\",", "name", UnderscoresToCamelCase(descriptor_->field(i)));
-	  if (descriptor_->field(i)->type() == FieldDescriptor::TYPE_MESSAGE) {
-		  
-		string p = descriptor_->field(i)->message_type()->file()->options().java_package();
-		if(!p.empty()) {
-			p = p.append(".");
-		}		
-		  
-	    printer->Print("\"$package$$messagetype$\","
-						 ,"package",p
-						 ,"messagetype", descriptor_->field(i)->message_type()->name());
-	  } else {
-		  printer->Print("\"\",");
-	  }
-	  printer->Print("Descriptor.$type$,", "type", AllCapsTypeName(descriptor_->field(i)->type()));
-	  printer->Print("Descriptor.$label$,", "label", LabelName(descriptor_->field(i)->label()));
-	  printer->Print("$fieldNum$);", "fieldNum", SimpleItoa(descriptor_->field(i)->number()));
-	  printer->Print("\n");
+  // writeExternal() and readExternal() are inherited from Message.  The
+  // alias lets AMF find the class back when reading.
+  if (options_.externalizable) {
+    printer->Print(
+      "{\n"
+      "  registerClassAlias(\"$full_name$\", $classname$);\n"
+      "}\n"
+      "\n",
+      "full_name", descriptor_->full_name(),
+      "classname", descriptor_->name());
+  }
+			
+  // Lite messages carry no field names, which keeps them small but leaves
+  // Message without the descriptors it needs for masks and TextFormat.
+  // The others register their fields once, with their first instance.
+  if (GetOptimizeFor(descriptor_->file(), options_) !=
+      FileOptions::LITE_RUNTIME) {
+    printer->Print("override protected function registerFields():void {\n");
+    printer->Indent();
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      field_generators_.get(descriptor_->field(i))
+                       .Render(REGISTER_FIELD, printer);
+    }
+    printer->Outdent();
+    printer->Print("}\n");
   }
-  printer->Outdent();
-  printer->Print("}\n");
 
- // printer->Print(
- //   "\n"
-	//"private static final var defaultInstance:$classname$ = new $classname$();\n"
-	//"public static function getDefaultInstance():$classname$ {\n"
- //   "  return defaultInstance;\n"
- //   "}\n"
- //   "\n"
-	//"public function getDefaultInstanceForType():$classname$ {\n"
- //   "  return defaultInstance;\n"
- //   "}\n"
- //   "\n",
- //   "classname", descriptor_->name());
+  // One frozen instance per class, built on first use.  Unset message
+  // fields read as it through their get accessor, and the parsers replace
+  // it rather than merge into it.
+  printer->Print(
+    "\n"
+    "private static var defaultInstance:$classname$;\n"
+    "\n"
+    "/** The shared, read only instance with no field set. */\n"
+    "public static function getDefaultInstance():$classname$ {\n"
+    "  if (defaultInstance == null) {\n"
+    "    defaultInstance = new $classname$();\n"
+    "    defaultInstance.freeze();\n"
+    "  }\n"
+    "  return defaultInstance;\n"
+    "}\n"
+    "\n",
+    "classname", descriptor_->name());
 
   //printer->Print(
 	  //"public static final function getDescriptor():com.google.protobuf.Descriptors.Descriptor {\n"
@@ -324,23 +228,46 @@ void MessageGenerator::Generate(io::Printer* printer) {
   //  MessageGenerator(descriptor_->nested_type(i)).Generate(printer);
   //}
 
-  //for (int i = 0; i < descriptor_->extension_count(); i++) {
-  //  ExtensionGenerator(descriptor_->extension(i)).Generate(printer);
-  //}
+  for (int i = 0; i < descriptor_->extension_count(); i++) {
+    const FieldDescriptor* extension = descriptor_->extension(i);
+    ExtensionGenerator(extension, metadata_.field(extension)).Generate(printer);
+    printer->Print("\n");
+  }
 
   // Fields
+  bool table_driven = GetOptimizeFor(descriptor_->file(), options_) ==
+                      FileOptions::CODE_SIZE;
   for (int i = 0; i < descriptor_->field_count(); i++) {
-    PrintFieldComment(printer, descriptor_->field(i));
-    field_generators_.get(descriptor_->field(i)).GenerateMembers(printer);
+    PrintFieldComment(printer, metadata_.field(descriptor_->field(i)));
+    if (table_driven) {
+      field_generators_.get(descriptor_->field(i))
+                       .GenerateTableMembers(printer);
+    } else {
+      field_generators_.get(descriptor_->field(i)).GenerateMembers(printer);
+    }
     printer->Print("\n");
   }
 
-	//not supported for now - [Philippe Pascal (Sorrydevil) Oct15th 2009 - protobuf-actionscript3 project]
-  //if (descriptor_->file()->options().optimize_for() == FileOptions::SPEED) {
-//    GenerateIsInitialized(printer);
-//    GenerateMessageSerializationMethods(printer);
-//  }
-	//not supported for now -- EOB
+  // SPEED and LITE_RUNTIME messages get generated codecs, CODE_SIZE ones
+  // only describe their fields to the table driven codecs of Message.
+  // Lite messages have no text format.
+  switch (GetOptimizeFor(descriptor_->file(), options_)) {
+    case FileOptions::CODE_SIZE:
+      GenerateEnumValueNames(printer);
+      GenerateFieldTable(printer);
+      break;
+    case FileOptions::LITE_RUNTIME:
+      GenerateMessageSerializationMethods(printer);
+      GenerateMessageParsingMethods(printer);
+      break;
+    default:
+      GenerateEnumValueNames(printer);
+      GenerateMessageSerializationMethods(printer);
+      GenerateMessageParsingMethods(printer);
+      GenerateTextMethods(printer);
+      GenerateJsonMethods(printer);
+      break;
+  }
 
   //GenerateParseFromMethods(printer);
   //GenerateBuilder(printer);
@@ -353,8 +280,8 @@ void MessageGenerator::Generate(io::Printer* printer) {
 
 void MessageGenerator::
 GenerateMessageSerializationMethods(io::Printer* printer) {
-  scoped_array<const FieldDescriptor*> sorted_fields(
-    SortFieldsByNumber(descriptor_));
+  const vector<const FieldDescriptor*>& sorted_fields =
+    metadata_.sorted_fields();
 
   vector<const Descriptor::ExtensionRange*> sorted_extensions;
   for (int i = 0; i < descriptor_->extension_range_count(); ++i) {
@@ -364,15 +291,10 @@ GenerateMessageSerializationMethods(io::Printer* printer) {
        ExtensionRangeOrdering());
 
   printer->Print(
-    "public function writeTo(output:com.google.protobuf.CodedOutputStream) : void\n"
-    "{\n");
+    "\n"
+    "override public function writeToCodedStream(output:CodedOutputStream, mask:FieldMask = null):void {\n");
   printer->Indent();
-
-  if (descriptor_->extension_range_count() > 0) {
-    printer->Print(
-      "com.google.protobuf.GeneratedMessage.ExtendableMessage"
-      ".ExtensionWriter extensionWriter = new ExtensionWriter();\n");
-  }
+  GenerateMaskFallback(printer, "writeToCodedStream(output, mask)");
 
   // Merge the fields and the extension ranges, both sorted by field number.
   for (int i = 0, j = 0;
@@ -389,49 +311,25 @@ GenerateMessageSerializationMethods(io::Printer* printer) {
     }
   }
 
-  if (descriptor_->options().message_set_wire_format()) {
-    printer->Print(
-      "getUnknownFields().writeAsMessageSetTo(output);\n");
-  } else {
-    printer->Print(
-      "getUnknownFields().writeTo(output);\n");
-  }
-
   printer->Outdent();
   printer->Print(
     "}\n"
     "\n"
-	"private memoizedSerializedSize:int = -1;\n"
-	"public getSerializedSize():int {\n"
-	"  var size:int = memoizedSerializedSize;\n"
-    "  if (size != -1) return size;\n"
-    "\n"
-    "  size = 0;\n");
+    "override public function getSerializedSize():int {\n"
+    "  var size:int = 0;\n");
   printer->Indent();
 
   for (int i = 0; i < descriptor_->field_count(); i++) {
     field_generators_.get(sorted_fields[i]).GenerateSerializedSizeCode(printer);
   }
-
   if (descriptor_->extension_range_count() > 0) {
-    printer->Print(
-      "size += extensionsSerializedSize();\n");
-  }
-
-  if (descriptor_->options().message_set_wire_format()) {
-    printer->Print(
-      "size += getUnknownFields().getSerializedSizeAsMessageSet();\n");
-  } else {
-    printer->Print(
-      "size += getUnknownFields().getSerializedSize();\n");
+    printer->Print("size += getExtensionsSerializedSize();\n");
   }
 
   printer->Outdent();
   printer->Print(
-    "  memoizedSerializedSize = size;\n"
     "  return size;\n"
-    "}\n"
-    "\n");
+    "}\n");
 }
 
 void MessageGenerator::
@@ -488,7 +386,8 @@ void MessageGenerator::GenerateSerializeOneField(
 void MessageGenerator::GenerateSerializeOneExtensionRange(
     io::Printer* printer, const Descriptor::ExtensionRange* range) {
   printer->Print(
-    "extensionWriter.writeUntil($end$, output);\n",
+    "writeExtensions(output, $start$, $end$);\n",
+    "start", SimpleItoa(range->start),
     "end", SimpleItoa(range->end));
 }
 
@@ -498,13 +397,9 @@ void MessageGenerator::GenerateBuilder(io::Printer* printer) {
 
   GenerateCommonBuilderMethods(printer);
 
-  if (descriptor_->file()->options().optimize_for() == FileOptions::SPEED) {
-    GenerateBuilderParsingMethods(printer);
-  }
-
   for (int i = 0; i < descriptor_->field_count(); i++) {
     printer->Print("\n");
-    PrintFieldComment(printer, descriptor_->field(i));
+    PrintFieldComment(printer, metadata_.field(descriptor_->field(i)));
     field_generators_.get(descriptor_->field(i))
                      .GenerateBuilderMembers(printer);
   }
@@ -536,12 +431,7 @@ void MessageGenerator::GenerateCommonBuilderMethods(io::Printer* printer) {
 	"public function getDescriptors():Array {\n"
     "  return fieldDescriptors;\n"
     "}\n"
-    "\n"
-	"public static function getDefaultInstance():$classname$ {\n"
-	"  return new $classname$();\n"
-    "}\n"
-    "\n",
-	"classname", descriptor_->name());
+    "\n");
 
   // -----------------------------------------------------------------
 
@@ -623,55 +513,33 @@ void MessageGenerator::GenerateCommonBuilderMethods(io::Printer* printer) {
 
 // ===================================================================
 
-void MessageGenerator::GenerateBuilderParsingMethods(io::Printer* printer) {
-  scoped_array<const FieldDescriptor*> sorted_fields(
-    SortFieldsByNumber(descriptor_));
+void MessageGenerator::GenerateMessageParsingMethods(io::Printer* printer) {
+  const vector<const FieldDescriptor*>& sorted_fields =
+    metadata_.sorted_fields();
 
   printer->Print(
-    "public function mergeFrom(\n"
-	"    com.google.protobuf.CodedInputStream input):Builder\n"
-    "{\n"
-    "  return mergeFrom(input,\n"
-    "    com.google.protobuf.ExtensionRegistry.getEmptyRegistry());\n"
-    "}\n"
     "\n"
-    "public function mergeFrom(\n"
-    "    com.google.protobuf.CodedInputStream input,\n"
-	"    extensionRegistry:com.google.protobuf.ExtensionRegistry ):Builder\n"
-    "{\n");
+    "override public function readFromCodedStream(input:CodedInputStream, mask:FieldMask = null):void {\n");
   printer->Indent();
+  GenerateMaskFallback(printer, "readFromCodedStream(input, mask)");
 
   printer->Print(
-    "com.google.protobuf.UnknownFieldSet.Builder unknownFields =\n"
-    "  com.google.protobuf.UnknownFieldSet.newBuilder(\n"
-    "    this.getUnknownFields());\n"
-    "while (true) {\n");
+    "while (true) {\n"
+    "  var tag:int = input.readTag();\n"
+    "  switch (tag) {\n");
   printer->Indent();
-
-  printer->Print(
-    "int tag = input.readTag();\n"
-    "switch (tag) {\n");
   printer->Indent();
 
   printer->Print(
     "case 0:\n"          // zero signals EOF / limit reached
-    "  this.setUnknownFields(unknownFields.build());\n"
-    "  return this;\n"
-    "default: {\n"
-    "  if (!parseUnknownField(input, unknownFields,\n"
-    "                         extensionRegistry, tag)) {\n"
-    "    this.setUnknownFields(unknownFields.build());\n"
-    "    return this;\n"   // it's an endgroup tag
-    "  }\n"
-    "  break;\n"
-    "}\n");
+    "  return;\n");
 
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = sorted_fields[i];
-   uint32 tag = WireFormat::MakeTag(field);
+    uint32 tag = MakeFieldTag(field);
 
     printer->Print(
-      "case $tag$: {\n",
+      "case $tag$:\n",
       "tag", SimpleItoa(tag));
     printer->Indent();
 
@@ -679,18 +547,248 @@ void MessageGenerator::GenerateBuilderParsingMethods(io::Printer* printer) {
 
     printer->Outdent();
     printer->Print(
-      "  break;\n"
-      "}\n");
+      "  break;\n");
   }
 
+  // Tags in the extension ranges may be extensions known to the registry
+  // of the stream, readExtension() skips the others.
+  printer->Print(
+    "default:\n"
+    "  if (!$read$) {\n"
+    "    return;\n"   // it's an endgroup tag
+    "  }\n"
+    "  break;\n",
+    "read", descriptor_->extension_range_count() > 0 ?
+      "readExtension(input, tag)" : "input.skipField(tag)");
+
   printer->Outdent();
   printer->Outdent();
   printer->Outdent();
   printer->Print(
     "    }\n"     // switch (tag)
     "  }\n"       // while (true)
-    "}\n"
-    "\n");
+    "}\n");
+}
+
+void MessageGenerator::GenerateFieldTable(io::Printer* printer) {
+  const vector<const FieldDescriptor*>& sorted_fields =
+    metadata_.sorted_fields();
+
+  // One row per field, see FieldTable.as for the layout.
+  printer->Print(
+    "\n"
+    "private static const fieldTable:FieldTable = new FieldTable(\n"
+    "  Vector.<int>([\n");
+  printer->Indent();
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_ROW, printer);
+    printer->Print(i + 1 < descriptor_->field_count() ? ",\n" : "\n");
+  }
+  printer->Outdent();
+  printer->Print("]),\n"
+                 "Vector.<String>([");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (i > 0) printer->Print(", ");
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_NAME, printer);
+  }
+  printer->Print("]),\n"
+                 "Vector.<String>([");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (i > 0) printer->Print(", ");
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_TEXT_NAME,
+                                                   printer);
+  }
+  printer->Print("]),\n"
+                 "Vector.<String>([");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (i > 0) printer->Print(", ");
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_JSON_NAME,
+                                                   printer);
+  }
+  printer->Print("]),\n"
+                 "[");
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (i > 0) printer->Print(", ");
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_CLASS, printer);
+  }
+  printer->Print("]);\n");
+  printer->Outdent();
+
+  printer->Print(
+    "\n"
+    "override protected function getFieldTable():FieldTable {\n"
+    "  return fieldTable;\n"
+    "}\n");
+
+  // The initial values of the fields, by slot.
+  printer->Print(
+    "\n"
+    "public function $classname$() {\n"
+    "  fieldValues = [",
+    "classname", descriptor_->name());
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    if (i > 0) printer->Print(", ");
+    field_generators_.get(sorted_fields[i]).Render(FIELD_TABLE_DEFAULT,
+                                                   printer);
+  }
+  printer->Print("];\n"
+                 "}\n");
+}
+
+void MessageGenerator::GenerateTextMethods(io::Printer* printer) {
+  const vector<const FieldDescriptor*>& sorted_fields =
+    metadata_.sorted_fields();
+
+  printer->Print(
+    "\n"
+    "override public function writeText(output:TextWriter):void {\n");
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    field_generators_.get(sorted_fields[i]).GenerateTextPrintingCode(printer);
+  }
+  printer->Outdent();
+  printer->Print("}\n");
+
+  // Fields are looked up by their text format name, the only string
+  // comparison done per field.
+  printer->Print(
+    "\n"
+    "override public function readText(input:TextTokenizer):void {\n"
+    "  while (!input.atMessageEnd()) {\n"
+    "    var textFieldName:String = input.consumeIdentifier();\n"
+    "    switch (textFieldName) {\n");
+  printer->Indent();
+  printer->Indent();
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = sorted_fields[i];
+    printer->Print(
+      "case \"$text_name$\":\n",
+      "text_name", TextFieldName(field));
+    printer->Indent();
+    field_generators_.get(field).GenerateTextParsingCode(printer);
+    printer->Outdent();
+    printer->Print(
+      "  break;\n");
+  }
+  printer->Print(
+    "default:\n"
+    "  throw input.parseError(\"Message type \\\"$full_name$\\\" has no \" +\n"
+    "    \"field named \\\"\" + textFieldName + \"\\\".\");\n",
+    "full_name", descriptor_->full_name());
+  printer->Outdent();
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(
+    "    }\n"     // switch (textFieldName)
+    "  }\n"       // while
+    "}\n");
+}
+
+void MessageGenerator::GenerateJsonMethods(io::Printer* printer) {
+  const vector<const FieldDescriptor*>& sorted_fields =
+    metadata_.sorted_fields();
+
+  printer->Print(
+    "\n"
+    "override public function writeJSON(output:JsonWriter):void {\n");
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    field_generators_.get(sorted_fields[i]).GenerateJsonWritingCode(printer);
+  }
+  printer->Outdent();
+  printer->Print("}\n");
+
+  // Fields are looked up by their JSON name or .proto name.  Unknown
+  // members are rejected, like FieldTable and the reflective parser do.
+  printer->Print(
+    "\n"
+    "override public function fromJSONObject(object:Object):void {\n"
+    "  for (var jsonFieldName:String in object) {\n"
+    "    var value:* = object[jsonFieldName];\n"
+    "    switch (jsonFieldName) {\n");
+  printer->Indent();
+  printer->Indent();
+  printer->Indent();
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = sorted_fields[i];
+    const string& json_name = metadata_.field(field).json_name;
+    printer->Print(
+      "case \"$json_name$\":\n",
+      "json_name", json_name);
+    if (json_name != field->name()) {
+      printer->Print(
+        "case \"$proto_name$\":\n",
+        "proto_name", field->name());
+    }
+    // null stands for the default value.
+    printer->Print("  if (value != null) {\n");
+    printer->Indent();
+    printer->Indent();
+    field_generators_.get(field).GenerateJsonParsingCode(printer);
+    printer->Outdent();
+    printer->Outdent();
+    printer->Print(
+      "  }\n"
+      "  break;\n");
+  }
+  printer->Print(
+    "default:\n"
+    "  throw new InvalidProtocolBufferException(\"Message type \\\"$full_name$\\\" \" +\n"
+    "    \"has no field named \\\"\" + jsonFieldName + \"\\\".\");\n",
+    "full_name", descriptor_->full_name());
+  printer->Outdent();
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(
+    "    }\n"     // switch (jsonFieldName)
+    "  }\n"       // for
+    "}\n");
+}
+
+void MessageGenerator::GenerateEnumValueNames(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->field_count(); i++) {
+    const FieldDescriptor* field = descriptor_->field(i);
+    if (field->cpp_type() != FieldDescriptor::CPPTYPE_ENUM) continue;
+
+    printer->Print(
+      "private static const $value_names$:Object = {",
+      "value_names", metadata_.field(field).value_names);
+    const EnumDescriptor* type = field->enum_type();
+    // The first of aliased values names the number.
+    set<int> numbers;
+    for (int j = 0; j < type->value_count(); j++) {
+      if (!numbers.insert(type->value(j)->number()).second) continue;
+      printer->Print(
+        "$comma$\"$number$\": \"$name$\"",
+        "comma", j > 0 ? ", " : "",
+        "number", SimpleItoa(type->value(j)->number()),
+        "name", type->value(j)->name());
+    }
+    printer->Print("};\n");
+  }
+}
+
+void MessageGenerator::GenerateMaskFallback(io::Printer* printer,
+                                            const char* call) {
+  if (GetOptimizeFor(descriptor_->file(), options_) ==
+      FileOptions::LITE_RUNTIME) {
+    printer->Print(
+      "if (mask != null) {\n"
+      "  throw new ArgumentError(\"$classname$ is generated for \" +\n"
+      "    \"LITE_RUNTIME, field masks are not supported\");\n"
+      "}\n",
+      "classname", descriptor_->name());
+  } else {
+    // Masks need the registered fields, leave them to Message.
+    printer->Print(
+      "if (mask != null) {\n"
+      "  super.$call$;\n"
+      "  return;\n"
+      "}\n",
+      "call", call);
+  }
 }
 
 // ===================================================================
@@ -24,6 +24,8 @@
 #include <string>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/compiler/as3/as3_field.h>
+#include <google/protobuf/compiler/as3/as3_metadata.h>
+#include <google/protobuf/compiler/as3/as3_options.h>
 
 namespace google {
 namespace protobuf {
@@ -38,19 +40,29 @@ namespace as3 {
 
 class MessageGenerator {
  public:
-  explicit MessageGenerator(const Descriptor* descriptor);
+  MessageGenerator(const Descriptor* descriptor,
+                   const GeneratorOptions& options);
   ~MessageGenerator();
 
-  // All static variables have to be declared at the top-level of the file
-  // so that we can control initialization order, which is important for
-  // DescriptorProto bootstrapping to work.
-  void GenerateStaticVariables(io::Printer* printer);
-
   // Generate the class itself.
   void Generate(io::Printer* printer);
 
  private:
   void GenerateMessageSerializationMethods(io::Printer* printer);
+  void GenerateMessageParsingMethods(io::Printer* printer);
+  // Generates the FieldTable used by the codecs of CODE_SIZE messages.
+  void GenerateFieldTable(io::Printer* printer);
+  // Generates writeText() and readText(), see TextWriter.as and
+  // TextTokenizer.as.
+  void GenerateTextMethods(io::Printer* printer);
+  // Generates writeJSON() and fromJSONObject(), see JsonWriter.as and
+  // JsonReader.as.
+  void GenerateJsonMethods(io::Printer* printer);
+  // Generates the value names of the enum fields, used by the text format.
+  void GenerateEnumValueNames(io::Printer* printer);
+  // Prints the handling of the mask argument of the generated codecs,
+  // "call" being the method of Message to delegate to.
+  void GenerateMaskFallback(io::Printer* printer, const char* call);
   void GenerateParseFromMethods(io::Printer* printer);
   void GenerateSerializeOneField(io::Printer* printer,
                                  const FieldDescriptor* field);
@@ -59,10 +71,12 @@ class MessageGenerator {
 
   void GenerateBuilder(io::Printer* printer);
   void GenerateCommonBuilderMethods(io::Printer* printer);
-  void GenerateBuilderParsingMethods(io::Printer* printer);
   void GenerateIsInitialized(io::Printer* printer);
 
   const Descriptor* descriptor_;
+  const GeneratorOptions& options_;
+  // Computed once, before the field generators which are built from it.
+  MessageMetadata metadata_;
   FieldGeneratorMap field_generators_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MessageGenerator);
@@ -18,12 +18,10 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
-#include <map>
 #include <string>
 
 #include <google/protobuf/compiler/as3/as3_message_field.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
-#include <google/protobuf/io/printer.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/stubs/strutil.h>
 namespace google {
@@ -33,27 +31,31 @@ namespace as3 {
 
 namespace {
 
-// TODO(kenton):  Factor out a "SetCommonFieldVariables()" to get rid of
-//   repeat code between this and the other field types.
-void SetMessageVariables(const FieldDescriptor* descriptor,
-                         map<string, string>* variables) {
+void SetMessageValues(const FieldDescriptor* descriptor, string values[]) {
 	string package = FileAs3Package(descriptor->message_type()->file());
-  (*variables)["name"] =
-    UnderscoresToCamelCase(descriptor);
-  (*variables)["capitalized_name"] =
-    UnderscoresToCapitalizedCamelCase(descriptor);
-  (*variables)["number"] = SimpleItoa(descriptor->number());
   if(!package.empty()) {
-    (*variables)["java_package"] = package.append(".");
+    values[SLOT_JAVA_PACKAGE] = package.append(".");
   } else {
-    (*variables)["java_package"] = package;
+    values[SLOT_JAVA_PACKAGE] = package;
+  }
+  values[SLOT_TYPE] = descriptor->message_type()->name();
+}
+
+// Sets "write_value" and "value_size" for the message held in "value".
+// Groups are delimited by their start and end tags instead of a length, the
+// end tag is written after the value.
+void SetSerializationValues(const FieldDescriptor* descriptor,
+                            const string& value,
+                            string values[]) {
+  if (descriptor->type() == FieldDescriptor::TYPE_GROUP) {
+    values[SLOT_WRITE_VALUE] = value + ".writeToCodedStream(output);";
+    values[SLOT_VALUE_SIZE] =
+      values[SLOT_TAG_SIZE] + " + " + value + ".getSerializedSize()";
+  } else {
+    values[SLOT_WRITE_VALUE] = "output.writeMessageNoTag(" + value + ");";
+    values[SLOT_VALUE_SIZE] =
+      "CodedOutputStream.computeMessageSizeNoTag(" + value + ")";
   }
-  (*variables)["type"] = descriptor->message_type()->name();
-  (*variables)["label"] = SimpleItoa(descriptor->label());
-  (*variables)["parent"] = descriptor->containing_type()->name();
-  (*variables)["group_or_message"] =
-    (descriptor->type() == FieldDescriptor::TYPE_GROUP) ?
-    "Group" : "Message";
 }
 
 }  // namespace
@@ -61,45 +63,38 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
 // ===================================================================
 
 MessageFieldGenerator::
-MessageFieldGenerator(const FieldDescriptor* descriptor)
-  : descriptor_(descriptor) {
-  SetMessageVariables(descriptor, &variables_);
+MessageFieldGenerator(const FieldDescriptor* descriptor,
+                       const FieldMetadata& metadata)
+  : FieldGenerator(descriptor, metadata),
+    descriptor_(descriptor) {
+  SetMessageValues(descriptor, values_);
+  SetSerializationValues(descriptor, values_[SLOT_MEMBER_NAME], values_);
+  values_[SLOT_MEMBER_TYPE] = values_[SLOT_JAVA_PACKAGE] + values_[SLOT_TYPE];
+  values_[SLOT_MEMBER_DEFAULT] = "null";
 }
 
 MessageFieldGenerator::~MessageFieldGenerator() {}
 
 void MessageFieldGenerator::
-GenerateMembers(io::Printer* printer) const {	
-	printer->Print(variables_,
-				   "public var $name$:$java_package$$type$ = null;\n");}
+GenerateMembers(io::Printer* printer) const {
+  Render(MEMBERS, printer);
+  Render(MESSAGE_ACCESSORS, printer);
+}
+
+void MessageFieldGenerator::
+GenerateTableMembers(io::Printer* printer) const {
+  Render(TABLE_MEMBERS, printer);
+  Render(MESSAGE_ACCESSORS, printer);
+}
 
 void MessageFieldGenerator::
 GenerateBuilderMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public function get$capitalized_name$():$type$ {\n"
-    "  return $name$;\n"
-    "}\n"
-	"public function set$capitalized_name$(value:$type$):$parent$ {\n"
-    "  $name$ = value;\n"
-    "  return this;\n"
-    "}\n"
-	//"public function set$capitalized_name$(builderForValue:$type$.Builder):Builder {\n"
- //   "  result.has$capitalized_name$ = true;\n"
- //   "  result.$name$_ = builderForValue.build();\n"
- //   "  return this;\n"
- //   "}\n"
-	"public function clear$capitalized_name$():$parent$ {\n"
-    "  $name$ = $type$.getDefaultInstance();\n"
-    "  return this;\n"
-    "}\n");
+  Render(MESSAGE_BUILDER_MEMBERS, printer);
 }
 
 void MessageFieldGenerator::
 GenerateMergingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (other.has$capitalized_name$()) {\n"
-    "  merge$capitalized_name$(other.get$capitalized_name$());\n"
-    "}\n");
+  Render(MESSAGE_MERGING, printer);
 }
 
 void MessageFieldGenerator::
@@ -109,39 +104,45 @@ GenerateBuildingCode(io::Printer* printer) const {
 
 void MessageFieldGenerator::
 GenerateParsingCode(io::Printer* printer) const {
-  //printer->Print(variables_,
-  //  "$type$.Builder subBuilder = $type$.newBuilder();\n"
-  //  "if (has$capitalized_name$()) {\n"
-  //  "  subBuilder.mergeFrom(get$capitalized_name$());\n"
-  //  "}\n");
-
-  //if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
-  //  printer->Print(variables_,
-  //    "input.readGroup($number$, subBuilder, extensionRegistry);\n");
-  //} else {
-  //  printer->Print(variables_,
-  //    "input.readMessage(subBuilder, extensionRegistry);\n");
-  //}
-
-  //printer->Print(variables_,
-  //  "set$capitalized_name$(subBuilder.buildPartial());\n");
+  if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
+    Render(GROUP_PARSING, printer);
+  } else {
+    Render(MESSAGE_PARSING, printer);
+  }
 }
 
 void MessageFieldGenerator::
 GenerateSerializationCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (has$capitalized_name$()) {\n"
-    "  output.write$group_or_message$($number$, get$capitalized_name$());\n"
-    "}\n");
+  if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
+    Render(GROUP_SERIALIZATION, printer);
+  } else {
+    Render(MESSAGE_SERIALIZATION, printer);
+  }
 }
 
 void MessageFieldGenerator::
 GenerateSerializedSizeCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (has$capitalized_name$()) {\n"
-    "  size += com.google.protobuf.CodedOutputStream\n"
-    "    .compute$group_or_message$Size($number$, get$capitalized_name$());\n"
-    "}\n");
+  Render(MESSAGE_SERIALIZED_SIZE, printer);
+}
+
+void MessageFieldGenerator::
+GenerateTextPrintingCode(io::Printer* printer) const {
+  Render(MESSAGE_TEXT_PRINTING, printer);
+}
+
+void MessageFieldGenerator::
+GenerateTextParsingCode(io::Printer* printer) const {
+  Render(MESSAGE_TEXT_PARSING, printer);
+}
+
+void MessageFieldGenerator::
+GenerateJsonWritingCode(io::Printer* printer) const {
+  Render(MESSAGE_JSON_WRITING, printer);
+}
+
+void MessageFieldGenerator::
+GenerateJsonParsingCode(io::Printer* printer) const {
+  Render(MESSAGE_JSON_PARSING, printer);
 }
 
 string MessageFieldGenerator::GetBoxedType() const {
@@ -151,59 +152,27 @@ string MessageFieldGenerator::GetBoxedType() const {
 // ===================================================================
 
 RepeatedMessageFieldGenerator::
-RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor)
-  : descriptor_(descriptor) {
-  SetMessageVariables(descriptor, &variables_);
+RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor,
+                               const FieldMetadata& metadata)
+  : FieldGenerator(descriptor, metadata),
+    descriptor_(descriptor) {
+  SetMessageValues(descriptor, values_);
+  values_[SLOT_ELEMENT] = metadata.name + "Element";
+  SetSerializationValues(descriptor, values_[SLOT_ELEMENT], values_);
+  values_[SLOT_MEMBER_TYPE] = "Array";
+  values_[SLOT_MEMBER_DEFAULT] = "new Array()";
 }
 
 RepeatedMessageFieldGenerator::~RepeatedMessageFieldGenerator() {}
 
 void RepeatedMessageFieldGenerator::
 GenerateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	  "public var $name$:Array = new Array();\n\n"
-	  "//fix bug 1 protobuf-actionscript3\n"
-	  "//dummy var using $java_package$ necessary to avoid following exception\n"
-	  "//ReferenceError: Error #1065: Variable NetworkInfo is not defined.\n"
-	  "//at global/flash.utils::getDefinitionByName()\n"
-	  "//at com.google.protobuf::Message/readFromCodedStream()\n"
-	  "private var $name$Dummy:$java_package$$type$ = null;\n");
+  Render(MEMBERS, printer);
 }
 
 void RepeatedMessageFieldGenerator::
 GenerateBuilderMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public function get$capitalized_name$List():Array {\n"
-    "  return $name$;\n"
-    "}\n"
-	"public function get$capitalized_name$Count():int {\n"
-    "  return $name$.length;\n"
-    "}\n"
-	"public function get$capitalized_name$(index:int):$type$ {\n"
-	"  return $name$[index];\n"
-    "}\n"
-	"public function set$capitalized_name$(index:int, value:$type$):$parent$ {\n"
-	"  $name$[index] = value;\n"
-    "  return this;\n"
-    "}\n"
-	"public function add$capitalized_name$(value:$type$):$parent$ {\n"
-    //"  if ($name$_.isEmpty()) {\n"
-    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
-    //"  }\n"
-    "  $name$.push(value);\n"
-    "  return this;\n"
-    "}\n"
-	"public function addAll$capitalized_name$(values:Array):$parent$ {\n"
-    //"  if ($name$_.isEmpty()) {\n"
-    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
-    //"  }\n"
-    "  $name$.concat(values);\n"
-    "  return this;\n"
-    "}\n"
-	"public function clear$capitalized_name$():$parent$  {\n"
-	"  $name$ = new Array();\n"
-    "  return this;\n"
-    "}\n");
+  Render(REPEATED_MESSAGE_BUILDER_MEMBERS, printer);
 }
 
 void RepeatedMessageFieldGenerator::
@@ -228,36 +197,45 @@ GenerateBuildingCode(io::Printer* printer) const {
 
 void RepeatedMessageFieldGenerator::
 GenerateParsingCode(io::Printer* printer) const {
-  //printer->Print(variables_,
-  //  "var subBuilder;$type$.Builder = $type$.newBuilder();\n");
-
-  //if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
-  //  printer->Print(variables_,
-  //    "input.readGroup($number$, subBuilder, extensionRegistry);\n");
-  //} else {
-  //  printer->Print(variables_,
-  //    "input.readMessage(subBuilder, extensionRegistry);\n");
-  //}
-
-  //printer->Print(variables_,
-  //  "add$capitalized_name$(subBuilder.buildPartial());\n");
+  if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
+    Render(REPEATED_GROUP_PARSING, printer);
+  } else {
+    Render(REPEATED_MESSAGE_PARSING, printer);
+  }
 }
 
 void RepeatedMessageFieldGenerator::
 GenerateSerializationCode(io::Printer* printer) const {
- // printer->Print(variables_,
-	//"for (var element:$type$ in get$capitalized_name$List()) {\n"
- //   "  output.write$group_or_message$($number$, element);\n"
- //   "}\n");
+  if (descriptor_->type() == FieldDescriptor::TYPE_GROUP) {
+    Render(REPEATED_GROUP_SERIALIZATION, printer);
+  } else {
+    Render(REPEATED_MESSAGE_SERIALIZATION, printer);
+  }
 }
 
 void RepeatedMessageFieldGenerator::
 GenerateSerializedSizeCode(io::Printer* printer) const {
- // printer->Print(variables_,
-	//"for (var element:$type$ in get$capitalized_name$List()) {\n"
- //   "  size += com.google.protobuf.CodedOutputStream\n"
- //   "    .compute$group_or_message$Size($number$, element);\n"
- //   "}\n");
+  Render(REPEATED_MESSAGE_SERIALIZED_SIZE, printer);
+}
+
+void RepeatedMessageFieldGenerator::
+GenerateTextPrintingCode(io::Printer* printer) const {
+  Render(REPEATED_MESSAGE_TEXT_PRINTING, printer);
+}
+
+void RepeatedMessageFieldGenerator::
+GenerateTextParsingCode(io::Printer* printer) const {
+  Render(REPEATED_MESSAGE_TEXT_PARSING, printer);
+}
+
+void RepeatedMessageFieldGenerator::
+GenerateJsonWritingCode(io::Printer* printer) const {
+  Render(REPEATED_MESSAGE_JSON_WRITING, printer);
+}
+
+void RepeatedMessageFieldGenerator::
+GenerateJsonParsingCode(io::Printer* printer) const {
+  Render(REPEATED_MESSAGE_JSON_PARSING, printer);
 }
 
 string RepeatedMessageFieldGenerator::GetBoxedType() const {
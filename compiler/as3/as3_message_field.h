@@ -21,7 +21,6 @@
 #ifndef GOOGLE_PROTOBUF_COMPILER_AS3_MESSAGE_FIELD_H__
 #define GOOGLE_PROTOBUF_COMPILER_AS3_MESSAGE_FIELD_H__
 
-#include <map>
 #include <string>
 #include <google/protobuf/compiler/as3/as3_field.h>
 
@@ -32,30 +31,36 @@ namespace as3 {
 
 class MessageFieldGenerator : public FieldGenerator {
  public:
-  explicit MessageFieldGenerator(const FieldDescriptor* descriptor);
+  MessageFieldGenerator(const FieldDescriptor* descriptor,
+                         const FieldMetadata& metadata);
   ~MessageFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
   void GenerateMembers(io::Printer* printer) const;
+  void GenerateTableMembers(io::Printer* printer) const;
   void GenerateBuilderMembers(io::Printer* printer) const;
   void GenerateMergingCode(io::Printer* printer) const;
   void GenerateBuildingCode(io::Printer* printer) const;
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MessageFieldGenerator);
 };
 
 class RepeatedMessageFieldGenerator : public FieldGenerator {
  public:
-  explicit RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor);
+  RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor,
+                                 const FieldMetadata& metadata);
   ~RepeatedMessageFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
@@ -66,12 +71,15 @@ class RepeatedMessageFieldGenerator : public FieldGenerator {
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(RepeatedMessageFieldGenerator);
 };
@@ -0,0 +1,103 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include <google/protobuf/compiler/as3/as3_metadata.h>
+#include <google/protobuf/compiler/as3/as3_helpers.h>
+#include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/stl_util-inl.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+namespace {
+
+struct FieldOrderingByNumber {
+  inline bool operator()(const FieldDescriptor* a,
+                         const FieldDescriptor* b) const {
+    return a->number() < b->number();
+  }
+};
+
+}  // namespace
+
+FieldMetadata::FieldMetadata(const FieldDescriptor* field)
+  : name(UnderscoresToCamelCase(field)),
+    capitalized_name(UnderscoresToCapitalizedCamelCase(field)),
+    number(SimpleItoa(field->number())),
+    text_name(TextFieldName(field)),
+    json_name(JsonFieldName(field)),
+    parent(field->containing_type()->name()),
+    tag(MakeFieldTag(field)) {
+  // DebugString() prints the whole field, group bodies included, so it is
+  // only called once per field.
+  string definition = field->DebugString();
+  comment = definition.substr(0, definition.find_first_of('\n'));
+
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    type_class = QualifiedMessageClassName(field->message_type());
+  } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+    type_class = ClassName(field->enum_type());
+    value_names = EnumValueNamesName(field);
+  }
+
+  tag_size = SimpleItoa(TagSize(tag));
+  write_tag = WriteTagStatement(tag);
+  if (field->type() == FieldDescriptor::TYPE_GROUP) {
+    // The end tag has the same field number with WIRETYPE_END_GROUP.
+    write_end_tag = WriteTagStatement(tag + 1);
+  }
+}
+
+FieldMetadata::~FieldMetadata() {}
+
+MessageMetadata::MessageMetadata(const Descriptor* descriptor)
+  : descriptor_(descriptor) {
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    fields_.push_back(new FieldMetadata(descriptor->field(i)));
+    sorted_fields_.push_back(descriptor->field(i));
+  }
+  for (int i = 0; i < descriptor->extension_count(); i++) {
+    extensions_.push_back(new FieldMetadata(descriptor->extension(i)));
+  }
+  sort(sorted_fields_.begin(), sorted_fields_.end(), FieldOrderingByNumber());
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    fields_[sorted_fields_[i]->index()]->slot = SimpleItoa(i);
+  }
+}
+
+MessageMetadata::~MessageMetadata() {
+  STLDeleteElements(&fields_);
+  STLDeleteElements(&extensions_);
+}
+
+const FieldMetadata& MessageMetadata::field(
+    const FieldDescriptor* field) const {
+  if (field->is_extension()) {
+    GOOGLE_CHECK_EQ(field->extension_scope(), descriptor_);
+    return *extensions_[field->index()];
+  }
+  GOOGLE_CHECK_EQ(field->containing_type(), descriptor_);
+  return *fields_[field->index()];
+}
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
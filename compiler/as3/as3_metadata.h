@@ -0,0 +1,98 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Metadata of the descriptors, computed once per run by the generator of
+// each message and shared by the generators of its fields and extensions.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_AS3_METADATA_H__
+#define GOOGLE_PROTOBUF_COMPILER_AS3_METADATA_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/descriptor.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+// What the generators derive from a field or extension, rather than each of
+// them deriving it again.
+struct FieldMetadata {
+  explicit FieldMetadata(const FieldDescriptor* field);
+  ~FieldMetadata();
+
+  string name;              // e.g. "fooBar", see UnderscoresToCamelCase().
+  string capitalized_name;  // e.g. "FooBar".
+  string number;
+  string text_name;         // See TextFieldName().
+  string json_name;         // See JsonFieldName().
+  string parent;            // The class name of the containing message.
+  string slot;              // The index in the sorted fields, see FieldTable.
+
+  // The first line of the field's definition, e.g.
+  // "optional int32 foo_bar = 1;", printed above its members.
+  string comment;
+
+  // The qualified class of message and group fields, see
+  // QualifiedMessageClassName(), or the class of enum fields, see
+  // ClassName().  Empty for the other fields.
+  string type_class;
+
+  // The member mapping the numbers of the values of enum fields to their
+  // names, see EnumValueNamesName().  Empty for the other fields.
+  string value_names;
+
+  // The tag as written on the wire, its size and the statements writing it,
+  // see MakeFieldTag() and WriteTagStatement().  The end tag is only set for
+  // groups.
+  uint32 tag;
+  string tag_size;
+  string write_tag;
+  string write_end_tag;
+};
+
+// The metadata of the fields and extensions of a message, by index, and its
+// fields in the order they are written.
+class MessageMetadata {
+ public:
+  explicit MessageMetadata(const Descriptor* descriptor);
+  ~MessageMetadata();
+
+  // Returns the metadata of a field or extension declared in the message.
+  const FieldMetadata& field(const FieldDescriptor* field) const;
+
+  // The fields sorted by number.
+  const vector<const FieldDescriptor*>& sorted_fields() const {
+    return sorted_fields_;
+  }
+
+ private:
+  const Descriptor* descriptor_;
+  vector<FieldMetadata*> fields_;
+  vector<FieldMetadata*> extensions_;
+  vector<const FieldDescriptor*> sorted_fields_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MessageMetadata);
+};
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_AS3_METADATA_H__
@@ -0,0 +1,66 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_AS3_OPTIONS_H__
+#define GOOGLE_PROTOBUF_COMPILER_AS3_OPTIONS_H__
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+// Generator options, parsed by As3Generator::Generate() from the parameter
+// of --as3_out, e.g. "--as3_out=optimize=code_size:out".
+struct GeneratorOptions {
+  GeneratorOptions()
+    : override_optimize_for(false),
+      optimize_for(FileOptions::SPEED),
+      externalizable(false) {}
+
+  // Set by "optimize=speed|code_size|lite".  When true, optimize_for
+  // replaces the optimize_for option of every generated file.
+  bool override_optimize_for;
+  FileOptions::OptimizeMode optimize_for;
+
+  // Set by "externalizable".  Messages then implement IExternalizable, so
+  // AMF carries them as protobuf bytes, and register a class alias named
+  // after their full .proto name.
+  bool externalizable;
+};
+
+// Returns the optimization mode the code for the given file is generated
+// with:
+//   SPEED:        serialization and parsing are fully generated.
+//   CODE_SIZE:    messages only describe their fields in a FieldTable,
+//                 interpreted by the codecs of Message.
+//   LITE_RUNTIME: like SPEED, but without the field registrations, so
+//                 descriptor names, text format, JSON and field masks are not
+//                 available.
+inline FileOptions::OptimizeMode GetOptimizeFor(
+    const FileDescriptor* file, const GeneratorOptions& options) {
+  if (options.override_optimize_for) return options.optimize_for;
+  return file->options().optimize_for();
+}
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_AS3_OPTIONS_H__
@@ -18,13 +18,11 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
-#include <map>
 #include <string>
 
 #include <google/protobuf/compiler/as3/as3_primitive_field.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
-#include <google/protobuf/io/printer.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
 
@@ -84,6 +82,34 @@ const char* GetCapitalizedType(const FieldDescriptor* field) {
   return NULL;
 }
 
+// Returns the suffix of the TextWriter.print*(), TextTokenizer.consume*(),
+// JsonWriter.write*() and JsonReader.parse*() methods handling values of the
+// field.
+const char* TextFormatType(const FieldDescriptor* field) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32   :
+    case FieldDescriptor::TYPE_SINT32  :
+    case FieldDescriptor::TYPE_SFIXED32: return "Int32"  ;
+    case FieldDescriptor::TYPE_UINT32  :
+    case FieldDescriptor::TYPE_FIXED32 : return "UInt32" ;
+    case FieldDescriptor::TYPE_INT64   :
+    case FieldDescriptor::TYPE_SFIXED64: return "Int64"  ;
+    case FieldDescriptor::TYPE_SINT64  : return "SInt64" ;
+    case FieldDescriptor::TYPE_UINT64  :
+    case FieldDescriptor::TYPE_FIXED64 : return "UInt64" ;
+    case FieldDescriptor::TYPE_FLOAT   :
+    case FieldDescriptor::TYPE_DOUBLE  : return "Double" ;
+    case FieldDescriptor::TYPE_BOOL    : return "Bool"   ;
+    case FieldDescriptor::TYPE_STRING  : return "String" ;
+    case FieldDescriptor::TYPE_BYTES   : return "Bytes"  ;
+    default:
+      break;
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return NULL;
+}
+
 bool AllPrintableAscii(const string& text) {
   // Cannot use isprint() because it's locale-specific.  :(
   for (int i = 0; i < text.size(); i++) {
@@ -157,19 +183,128 @@ string DefaultValue(const FieldDescriptor* field) {
   return "";
 }
 
-void SetPrimitiveVariables(const FieldDescriptor* descriptor,
-                           map<string, string>* variables) {
-  (*variables)["name"] =
-    UnderscoresToCamelCase(descriptor);
-  (*variables)["capitalized_name"] =
-    UnderscoresToCapitalizedCamelCase(descriptor);
-  (*variables)["number"] = SimpleItoa(descriptor->number());
-  (*variables)["type"] = PrimitiveTypeName(GetAs3Type(descriptor));
-  (*variables)["boxed_type"] = BoxedPrimitiveTypeName(GetAs3Type(descriptor));
-  (*variables)["default"] = DefaultValue(descriptor);
-  (*variables)["capitalized_type"] = GetCapitalizedType(descriptor);
-  (*variables)["parent"] = descriptor->containing_type()->name();
+// Returns the CodedOutputStream call writing the untagged value held in the
+// As3 expression "value".
+string WriteValueCode(const FieldDescriptor* field, const string& value) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_UINT32:
+      return "output.writeRawVarint32(" + value + ");";
+    case FieldDescriptor::TYPE_SINT32:
+      return "output.writeRawVarint32("
+             "CodedOutputStream.encodeZigZag32(" + value + "));";
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+      return "output.writeRawLittleEndian32(" + value + ");";
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT64:
+      return "output.writeRawVarint64(" + value + ");";
+    case FieldDescriptor::TYPE_SINT64:
+      return "output.writeRawVarint64("
+             "CodedOutputStream.encodeZigZag64(" + value + "));";
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+      return "output.writeRawLittleEndian64(" + value + ");";
+    case FieldDescriptor::TYPE_FLOAT:
+      return "output.writeRawFloat(" + value + ");";
+    case FieldDescriptor::TYPE_DOUBLE:
+      return "output.writeRawDouble(" + value + ");";
+    case FieldDescriptor::TYPE_BOOL:
+      return "output.writeRawByte(" + value + " ? 1 : 0);";
+    case FieldDescriptor::TYPE_STRING:
+      return "output.writeStringNoTag(" + value + ");";
+    case FieldDescriptor::TYPE_BYTES:
+      return "output.writeBytesNoTag(" + value + ");";
+    default:
+      break;
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return "";
+}
+
+// Returns the number of bytes of the untagged value on the wire, or -1 if it
+// depends on the value.
+int FixedValueSize(const FieldDescriptor* field) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_FLOAT:
+      return 4;
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+      return 8;
+    case FieldDescriptor::TYPE_BOOL:
+      return 1;
+    default:
+      return -1;
+  }
+}
+
+// Returns the As3 expression computing the size of the untagged value held
+// in the As3 expression "value".  Only valid if FixedValueSize() is -1.
+string ValueSizeCode(const FieldDescriptor* field, const string& value) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_UINT32:
+      return "CodedOutputStream.computeRawVarint32Size(" + value + ")";
+    case FieldDescriptor::TYPE_SINT32:
+      return "CodedOutputStream.computeRawVarint32Size("
+             "CodedOutputStream.encodeZigZag32(" + value + "))";
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT64:
+      return "CodedOutputStream.computeRawVarint64Size(" + value + ")";
+    case FieldDescriptor::TYPE_SINT64:
+      return "CodedOutputStream.computeRawVarint64Size("
+             "CodedOutputStream.encodeZigZag64(" + value + "))";
+    case FieldDescriptor::TYPE_STRING:
+      return "CodedOutputStream.computeStringSizeNoTag(" + value + ")";
+    case FieldDescriptor::TYPE_BYTES:
+      return "CodedOutputStream.computeBytesSizeNoTag(" + value + ")";
+    default:
+      break;
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return "";
+}
+
+// Sets "write_value" and "value_size" for the value held in "value".  When
+// the size of the value is known, "fixed_size" is set to the size of the
+// whole field, tag included.
+void SetSerializationValues(const FieldDescriptor* descriptor,
+                            const string& value,
+                            string values[]) {
+  values[SLOT_WRITE_VALUE] = WriteValueCode(descriptor, value);
+  int fixed_size = FixedValueSize(descriptor);
+  if (fixed_size == -1) {
+    values[SLOT_VALUE_SIZE] = ValueSizeCode(descriptor, value);
+  } else {
+    values[SLOT_FIXED_SIZE] =
+      SimpleItoa(TagSize(MakeFieldTag(descriptor)) + fixed_size);
+  }
+}
+
+// Strings, bytes and 64 bits integers are objects which may be null.
+bool IsNullable(const FieldDescriptor* descriptor) {
+  switch (GetAs3Type(descriptor)) {
+    case AS3TYPE_LONG:
+    case AS3TYPE_STRING:
+    case AS3TYPE_BYTES:
+      return true;
+    default:
+      return false;
+  }
+}
 
+void SetPrimitiveValues(const FieldDescriptor* descriptor,
+                        string values[]) {
+  values[SLOT_TYPE] = PrimitiveTypeName(GetAs3Type(descriptor));
+  values[SLOT_BOXED_TYPE] = BoxedPrimitiveTypeName(GetAs3Type(descriptor));
+  values[SLOT_DEFAULT] = DefaultValue(descriptor);
+  values[SLOT_CAPITALIZED_TYPE] = GetCapitalizedType(descriptor);
+  values[SLOT_TEXT_TYPE] = TextFormatType(descriptor);
 }
 
 }  // namespace
@@ -177,41 +312,31 @@ void SetPrimitiveVariables(const FieldDescriptor* descriptor,
 // ===================================================================
 
 PrimitiveFieldGenerator::
-PrimitiveFieldGenerator(const FieldDescriptor* descriptor)
-  : descriptor_(descriptor) {
-  SetPrimitiveVariables(descriptor, &variables_);
+PrimitiveFieldGenerator(const FieldDescriptor* descriptor,
+                         const FieldMetadata& metadata)
+  : FieldGenerator(descriptor, metadata),
+    descriptor_(descriptor) {
+  SetPrimitiveValues(descriptor, values_);
+  SetSerializationValues(descriptor, values_[SLOT_MEMBER_NAME], values_);
+  values_[SLOT_MEMBER_TYPE] = values_[SLOT_TYPE];
+  values_[SLOT_MEMBER_DEFAULT] = values_[SLOT_DEFAULT];
 }
 
 PrimitiveFieldGenerator::~PrimitiveFieldGenerator() {}
 
 void PrimitiveFieldGenerator::
 GenerateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public var $name$:$type$ = $default$;\n");
+  Render(MEMBERS, printer);
 }
 
 void PrimitiveFieldGenerator::
 GenerateBuilderMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public function get$capitalized_name$():$type$  {\n"
-    "  return $name$;\n"
-    "}\n"
-	"public function set$capitalized_name$(value:$type$):$parent$ {\n"
-    "  $name$ = value;\n"
-    "  return this;\n"
-    "}\n"
-	"public function clear$capitalized_name$():$parent$ {\n"
-    "  $name$ = $default$;\n"
-    "  return this;\n"
-    "}\n");
+  Render(PRIMITIVE_BUILDER_MEMBERS, printer);
 }
 
 void PrimitiveFieldGenerator::
 GenerateMergingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (other.has$capitalized_name$()) {\n"
-    "  set$capitalized_name$(other.get$capitalized_name$());\n"
-    "}\n");
+  Render(PRIMITIVE_MERGING, printer);
 }
 
 void PrimitiveFieldGenerator::
@@ -221,25 +346,55 @@ GenerateBuildingCode(io::Printer* printer) const {
 
 void PrimitiveFieldGenerator::
 GenerateParsingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "set$capitalized_name$(input.read$capitalized_type$());\n");
+  Render(PRIMITIVE_PARSING, printer);
 }
 
 void PrimitiveFieldGenerator::
 GenerateSerializationCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (has$capitalized_name$()) {\n"
-    "  output.write$capitalized_type$($number$, get$capitalized_name$());\n"
-    "}\n");
+  if (IsNullable(descriptor_)) {
+    Render(NULLABLE_PRIMITIVE_SERIALIZATION, printer);
+  } else {
+    Render(PRIMITIVE_SERIALIZATION, printer);
+  }
 }
 
 void PrimitiveFieldGenerator::
 GenerateSerializedSizeCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (has$capitalized_name$()) {\n"
-    "  size += com.google.protobuf.CodedOutputStream\n"
-    "    .compute$capitalized_type$Size($number$, get$capitalized_name$());\n"
-    "}\n");
+  if (!values_[SLOT_FIXED_SIZE].empty()) {
+    Render(FIXED_PRIMITIVE_SERIALIZED_SIZE, printer);
+  } else if (IsNullable(descriptor_)) {
+    Render(NULLABLE_PRIMITIVE_SERIALIZED_SIZE, printer);
+  } else {
+    Render(PRIMITIVE_SERIALIZED_SIZE, printer);
+  }
+}
+
+void PrimitiveFieldGenerator::
+GenerateTextPrintingCode(io::Printer* printer) const {
+  if (IsNullable(descriptor_)) {
+    Render(NULLABLE_PRIMITIVE_TEXT_PRINTING, printer);
+  } else {
+    Render(PRIMITIVE_TEXT_PRINTING, printer);
+  }
+}
+
+void PrimitiveFieldGenerator::
+GenerateTextParsingCode(io::Printer* printer) const {
+  Render(PRIMITIVE_TEXT_PARSING, printer);
+}
+
+void PrimitiveFieldGenerator::
+GenerateJsonWritingCode(io::Printer* printer) const {
+  if (IsNullable(descriptor_)) {
+    Render(NULLABLE_PRIMITIVE_JSON_WRITING, printer);
+  } else {
+    Render(PRIMITIVE_JSON_WRITING, printer);
+  }
+}
+
+void PrimitiveFieldGenerator::
+GenerateJsonParsingCode(io::Printer* printer) const {
+  Render(PRIMITIVE_JSON_PARSING, printer);
 }
 
 string PrimitiveFieldGenerator::GetBoxedType() const {
@@ -249,97 +404,76 @@ string PrimitiveFieldGenerator::GetBoxedType() const {
 // ===================================================================
 
 RepeatedPrimitiveFieldGenerator::
-RepeatedPrimitiveFieldGenerator(const FieldDescriptor* descriptor)
-  : descriptor_(descriptor) {
-  SetPrimitiveVariables(descriptor, &variables_);
+RepeatedPrimitiveFieldGenerator(const FieldDescriptor* descriptor,
+                                 const FieldMetadata& metadata)
+  : FieldGenerator(descriptor, metadata),
+    descriptor_(descriptor) {
+  SetPrimitiveValues(descriptor, values_);
+  values_[SLOT_ELEMENT] = metadata.name + "Element";
+  SetSerializationValues(descriptor, values_[SLOT_ELEMENT], values_);
+  values_[SLOT_MEMBER_TYPE] = "Array";
+  values_[SLOT_MEMBER_DEFAULT] = "new Array()";
 }
 
 RepeatedPrimitiveFieldGenerator::~RepeatedPrimitiveFieldGenerator() {}
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public var $name$:Array = new Array();"
-    "\n");
+  Render(MEMBERS, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateBuilderMembers(io::Printer* printer) const {
-  printer->Print(variables_,
-	"public function get$capitalized_name$List():Array {\n"
-    "  return $name$;\n"
-    "}\n"
-	"public function get$capitalized_name$Count():int {\n"
-    "  return $name$.length;\n"
-    "}\n"
-	"public function get$capitalized_name$(index:int):$type$ {\n"
-	"  return $name$[index];\n"
-    "}\n"
-	"public function set$capitalized_name$(index:int, value:$type$):$parent$ {\n"
-	"  $name$[index] = value;\n"
-    "  return this;\n"
-    "}\n"
-	"public function add$capitalized_name$(value:$type$):$parent$ {\n"
-    //"  if ($name$_.isEmpty()) {\n"
-    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
-    //"  }\n"
-    "  $name$.push(value);\n"
-    "  return this;\n"
-    "}\n"
-	"public function addAll$capitalized_name$(values:Array):$parent$ {\n"
-    //"  if ($name$_.isEmpty()) {\n"
-    //"    $name$_ = new ArrayList<$boxed_type$>();\n"
-    //"  }\n"
-    "  $name$.concat(values);\n"
-    "  return this;\n"
-    "}\n"
-	"public function clear$capitalized_name$():$parent$  {\n"
-	"  $name$ = new Array();\n"
-    "  return this;\n"
-    "}\n");
+  Render(REPEATED_PRIMITIVE_BUILDER_MEMBERS, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateMergingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if (!other.$name$_.isEmpty()) {\n"
-    "  if ($name$_.isEmpty()) {\n"
-    "    $name$_ = new ArrayList<$boxed_type$>();\n"
-    "  }\n"
-    "  $name$_.addAll(other.$name$_);\n"
-    "}\n");
+  Render(REPEATED_PRIMITIVE_MERGING, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateBuildingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "if ($name$_ != Collections.EMPTY_LIST) {\n"
-    "  $name$_ =\n"
-    "    Collections.unmodifiableList($name$_);\n"
-    "}\n");
+  Render(REPEATED_PRIMITIVE_BUILDING, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateParsingCode(io::Printer* printer) const {
-  printer->Print(variables_,
-    "add$capitalized_name$(input.read$capitalized_type$());\n");
+  Render(REPEATED_PRIMITIVE_PARSING, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateSerializationCode(io::Printer* printer) const {
-  printer->Print(variables_,
-	"for (var element:$type$ , get$capitalized_name$List()) {\n"
-    "  output.write$capitalized_type$($number$, element);\n"
-    "}\n");
+  Render(REPEATED_PRIMITIVE_SERIALIZATION, printer);
 }
 
 void RepeatedPrimitiveFieldGenerator::
 GenerateSerializedSizeCode(io::Printer* printer) const {
-  printer->Print(variables_,
-	  "for (var element:$type$, get$capitalized_name$List()) {\n"
-    "  size += com.google.protobuf.CodedOutputStream\n"
-    "    .compute$capitalized_type$Size($number$, element);\n"
-    "}\n");
+  if (!values_[SLOT_FIXED_SIZE].empty()) {
+    Render(FIXED_REPEATED_PRIMITIVE_SERIALIZED_SIZE, printer);
+  } else {
+    Render(REPEATED_PRIMITIVE_SERIALIZED_SIZE, printer);
+  }
+}
+
+void RepeatedPrimitiveFieldGenerator::
+GenerateTextPrintingCode(io::Printer* printer) const {
+  Render(REPEATED_PRIMITIVE_TEXT_PRINTING, printer);
+}
+
+void RepeatedPrimitiveFieldGenerator::
+GenerateTextParsingCode(io::Printer* printer) const {
+  Render(REPEATED_PRIMITIVE_TEXT_PARSING, printer);
+}
+
+void RepeatedPrimitiveFieldGenerator::
+GenerateJsonWritingCode(io::Printer* printer) const {
+  Render(REPEATED_PRIMITIVE_JSON_WRITING, printer);
+}
+
+void RepeatedPrimitiveFieldGenerator::
+GenerateJsonParsingCode(io::Printer* printer) const {
+  Render(REPEATED_PRIMITIVE_JSON_PARSING, printer);
 }
 
 string RepeatedPrimitiveFieldGenerator::GetBoxedType() const {
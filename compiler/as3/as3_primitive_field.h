@@ -21,7 +21,6 @@
 #ifndef GOOGLE_PROTOBUF_COMPILER_AS3_PRIMITIVE_FIELD_H__
 #define GOOGLE_PROTOBUF_COMPILER_AS3_PRIMITIVE_FIELD_H__
 
-#include <map>
 #include <string>
 #include <google/protobuf/compiler/as3/as3_field.h>
 
@@ -32,7 +31,8 @@ namespace as3 {
 
 class PrimitiveFieldGenerator : public FieldGenerator {
  public:
-  explicit PrimitiveFieldGenerator(const FieldDescriptor* descriptor);
+  PrimitiveFieldGenerator(const FieldDescriptor* descriptor,
+                           const FieldMetadata& metadata);
   ~PrimitiveFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
@@ -43,19 +43,23 @@ class PrimitiveFieldGenerator : public FieldGenerator {
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PrimitiveFieldGenerator);
 };
 
 class RepeatedPrimitiveFieldGenerator : public FieldGenerator {
  public:
-  explicit RepeatedPrimitiveFieldGenerator(const FieldDescriptor* descriptor);
+  RepeatedPrimitiveFieldGenerator(const FieldDescriptor* descriptor,
+                                   const FieldMetadata& metadata);
   ~RepeatedPrimitiveFieldGenerator();
 
   // implements FieldGenerator ---------------------------------------
@@ -66,12 +70,15 @@ class RepeatedPrimitiveFieldGenerator : public FieldGenerator {
   void GenerateParsingCode(io::Printer* printer) const;
   void GenerateSerializationCode(io::Printer* printer) const;
   void GenerateSerializedSizeCode(io::Printer* printer) const;
+  void GenerateTextPrintingCode(io::Printer* printer) const;
+  void GenerateTextParsingCode(io::Printer* printer) const;
+  void GenerateJsonWritingCode(io::Printer* printer) const;
+  void GenerateJsonParsingCode(io::Printer* printer) const;
 
   string GetBoxedType() const;
 
  private:
   const FieldDescriptor* descriptor_;
-  map<string, string> variables_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(RepeatedPrimitiveFieldGenerator);
 };
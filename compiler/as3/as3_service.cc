@@ -18,10 +18,12 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
+#include <set>
 #include <google/protobuf/compiler/as3/as3_service.h>
 #include <google/protobuf/compiler/as3/as3_helpers.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/unknown_field_set.h>
 #include <google/protobuf/stubs/strutil.h>
 
 namespace google {
@@ -29,194 +31,121 @@ namespace protobuf {
 namespace compiler {
 namespace as3 {
 
-ServiceGenerator::ServiceGenerator(const ServiceDescriptor* descriptor)
-  : descriptor_(descriptor) {}
-
-ServiceGenerator::~ServiceGenerator() {}
-
-void ServiceGenerator::Generate(io::Printer* printer) {
-  //bool is_own_file = descriptor_->file()->options().java_multiple_files();
-  //printer->Print(
-  //  "public $static$ abstract class $classname$\n"
-  //  "    implements com.google.protobuf.Service {\n",
-  //  "static", is_own_file ? "" : "static",
-  //  "classname", descriptor_->name());
-  //printer->Indent();
-
-  //// Generate abstract method declarations.
-  //for (int i = 0; i < descriptor_->method_count(); i++) {
-  //  const MethodDescriptor* method = descriptor_->method(i);
-  //  map<string, string> vars;
-  //  vars["name"] = UnderscoresToCamelCase(method);
-  //  vars["input"] = ClassName(method->input_type());
-  //  vars["output"] = ClassName(method->output_type());
-  //  printer->Print(vars,
-  //    "public abstract void $name$(\n"
-  //    "    com.google.protobuf.RpcController controller,\n"
-  //    "    $input$ request,\n"
-  //    "    com.google.protobuf.RpcCallback<$output$> done);\n");
-  //}
-
-  //// Generate getDescriptor() and getDescriptorForType().
-  //printer->Print(
-  //  "\n"
-  //  "public static final\n"
-  //  "    com.google.protobuf.Descriptors.ServiceDescriptor\n"
-  //  "    getDescriptor() {\n"
-  //  "  return $file$.getDescriptor().getServices().get($index$);\n"
-  //  "}\n"
-  //  "public final com.google.protobuf.Descriptors.ServiceDescriptor\n"
-  //  "    getDescriptorForType() {\n"
-  //  "  return getDescriptor();\n"
-  //  "}\n",
-  //  "file", ClassName(descriptor_->file()),
-  //  "index", SimpleItoa(descriptor_->index()));
-
-  //// Generate more stuff.
-  //GenerateCallMethod(printer);
-  //GenerateGetPrototype(REQUEST, printer);
-  //GenerateGetPrototype(RESPONSE, printer);
-  //GenerateStub(printer);
-
-  //printer->Outdent();
-  //printer->Print("}\n\n");
+namespace {
+
+// Field number of the cache_ttl_ms method option of as3_options.proto.
+const int kCacheTtlMsFieldNumber = 50301;
+
+// Returns the cache_ttl_ms option of the method, 0 when not set.  The
+// generator does not link as3_options.proto in, so the option is read
+// from the unknown fields protoc leaves in the MethodOptions.  TTLs above
+// int.MAX_VALUE, which CachingRpcChannel.cacheMethod() takes, are clamped
+// to it.
+int CacheTtlMs(const MethodDescriptor* method) {
+  const UnknownFieldSet& unknown = method->options().unknown_fields();
+  for (int i = 0; i < unknown.field_count(); i++) {
+    const UnknownField& field = unknown.field(i);
+    if (field.number() == kCacheTtlMsFieldNumber &&
+        field.type() == UnknownField::TYPE_VARINT) {
+      uint64 ttl = field.varint();
+      return ttl > static_cast<uint64>(kint32max) ? kint32max
+                                                  : static_cast<int>(ttl);
+    }
+  }
+  return 0;
 }
 
-void ServiceGenerator::GenerateCallMethod(io::Printer* printer) {
-  //printer->Print(
-  //  "\n"
-  //  "public final void callMethod(\n"
-  //  "    com.google.protobuf.Descriptors.MethodDescriptor method,\n"
-  //  "    com.google.protobuf.RpcController controller,\n"
-  //  "    com.google.protobuf.Message request,\n"
-  //  "    com.google.protobuf.RpcCallback<\n"
-  //  "      com.google.protobuf.Message> done) {\n"
-  //  "  if (method.getService() != getDescriptor()) {\n"
-  //  "    throw new as3.lang.IllegalArgumentException(\n"
-  //  "      \"Service.callMethod() given method descriptor for wrong \" +\n"
-  //  "      \"service type.\");\n"
-  //  "  }\n"
-  //  "  switch(method.getIndex()) {\n");
-  //printer->Indent();
-  //printer->Indent();
-
-  //for (int i = 0; i < descriptor_->method_count(); i++) {
-  //  const MethodDescriptor* method = descriptor_->method(i);
-  //  map<string, string> vars;
-  //  vars["index"] = SimpleItoa(i);
-  //  vars["method"] = UnderscoresToCamelCase(method);
-  //  vars["input"] = ClassName(method->input_type());
-  //  vars["output"] = ClassName(method->output_type());
-  //  printer->Print(vars,
-  //    "case $index$:\n"
-  //    "  this.$method$(controller, ($input$)request,\n"
-  //    "    com.google.protobuf.RpcUtil.<$output$>specializeCallback(\n"
-  //    "      done));\n"
-  //    "  return;\n");
-  //}
-
-  //printer->Print(
-  //  "default:\n"
-  //  "  throw new as3.lang.RuntimeException(\"Can't get here.\");\n");
-
-  //printer->Outdent();
-  //printer->Outdent();
-
-  //printer->Print(
-  //  "  }\n"
-  //  "}\n"
-  //  "\n");
+bool HasCachedMethods(const ServiceDescriptor* service) {
+  for (int i = 0; i < service->method_count(); i++) {
+    if (CacheTtlMs(service->method(i)) > 0) return true;
+  }
+  return false;
 }
 
-void ServiceGenerator::GenerateGetPrototype(RequestOrResponse which,
-                                            io::Printer* printer) {
-  //printer->Print(
-  //  "public final com.google.protobuf.Message\n"
-  //  "    get$request_or_response$Prototype(\n"
-  //  "    com.google.protobuf.Descriptors.MethodDescriptor method) {\n"
-  //  "  if (method.getService() != getDescriptor()) {\n"
-  //  "    throw new as3.lang.IllegalArgumentException(\n"
-  //  "      \"Service.get$request_or_response$Prototype() given method \" +\n"
-  //  "      \"descriptor for wrong service type.\");\n"
-  //  "  }\n"
-  //  "  switch(method.getIndex()) {\n",
-  //  "request_or_response", (which == REQUEST) ? "Request" : "Response");
-  //printer->Indent();
-  //printer->Indent();
+}  // namespace
 
-  //for (int i = 0; i < descriptor_->method_count(); i++) {
-  //  const MethodDescriptor* method = descriptor_->method(i);
-  //  map<string, string> vars;
-  //  vars["index"] = SimpleItoa(i);
-  //  vars["type"] = ClassName(
-  //    (which == REQUEST) ? method->input_type() : method->output_type());
-  //  printer->Print(vars,
-  //    "case $index$:\n"
-  //    "  return $type$.getDefaultInstance();\n");
-  //}
+ServiceGenerator::ServiceGenerator(const ServiceDescriptor* descriptor,
+                                   const GeneratorOptions& options)
+  : descriptor_(descriptor),
+    options_(options) {}
 
-  //printer->Print(
-  //  "default:\n"
-  //  "  throw new as3.lang.RuntimeException(\"Can't get here.\");\n");
-
-  //printer->Outdent();
-  //printer->Outdent();
+ServiceGenerator::~ServiceGenerator() {}
 
-  //printer->Print(
-  //  "  }\n"
-  //  "}\n"
-  //  "\n");
+void ServiceGenerator::Generate(io::Printer* printer) {
+  printer->Print("import com.google.protobuf.*;\n");
+  // Each message class once, in the order of first use.
+  set<string> imported;
+  for (int i = 0; i < descriptor_->method_count(); i++) {
+    const MethodDescriptor* method = descriptor_->method(i);
+    const string classes[] = {
+      QualifiedMessageClassName(method->input_type()),
+      QualifiedMessageClassName(method->output_type()),
+    };
+    for (int j = 0; j < 2; j++) {
+      if (imported.insert(classes[j]).second) {
+        printer->Print("import $class$;\n", "class", classes[j]);
+      }
+    }
+  }
+
+  // The generated class is a client stub: every rpc becomes a method
+  // taking the request and a callback, the calls going through whatever
+  // RpcChannel the stub was created with.
+  printer->Print(
+    "public class $classname$ {\n"
+    "  private var channel:RpcChannel;\n",
+    "classname", descriptor_->name());
+  printer->Indent();
+
+  // Methods with the cache_ttl_ms option go through a cache in front of
+  // the channel, shared by the calls of this stub.
+  bool cached = HasCachedMethods(descriptor_);
+  if (cached) {
+    printer->Print("private var cache:CachingRpcChannel;\n");
+  }
+  printer->Print(
+    "\n"
+    "public function $classname$(channel:RpcChannel) {\n"
+    "  this.channel = channel;\n",
+    "classname", descriptor_->name());
+  if (cached) {
+    printer->Print("  cache = new CachingRpcChannel(channel);\n");
+    for (int i = 0; i < descriptor_->method_count(); i++) {
+      const MethodDescriptor* method = descriptor_->method(i);
+      int ttl = CacheTtlMs(method);
+      if (ttl == 0) continue;
+      printer->Print("  cache.cacheMethod(\"$full_name$\", $ttl$);\n",
+                     "full_name", method->full_name(),
+                     "ttl", SimpleItoa(ttl));
+    }
+  }
+  printer->Print(
+    "}\n"
+    "\n"
+    "public function get rpcChannel():RpcChannel {\n"
+    "  return channel;\n"
+    "}\n");
+  GenerateStubMethods(printer);
+  printer->Outdent();
+  printer->Print("}\n");
 }
 
-void ServiceGenerator::GenerateStub(io::Printer* printer) {
-  //printer->Print(
-  //  "public static Stub newStub(\n"
-  //  "    com.google.protobuf.RpcChannel channel) {\n"
-  //  "  return new Stub(channel);\n"
-  //  "}\n"
-  //  "\n"
-  //  "public static final class Stub extends $classname$ {\n",
-  //  "classname", ClassName(descriptor_));
-  //printer->Indent();
-
-  //printer->Print(
-  //  "private Stub(com.google.protobuf.RpcChannel channel) {\n"
-  //  "  this.channel = channel;\n"
-  //  "}\n"
-  //  "\n"
-  //  "private final com.google.protobuf.RpcChannel channel;\n"
-  //  "\n"
-  //  "public com.google.protobuf.RpcChannel getChannel() {\n"
-  //  "  return channel;\n"
-  //  "}\n");
-
-  //for (int i = 0; i < descriptor_->method_count(); i++) {
-  //  const MethodDescriptor* method = descriptor_->method(i);
-  //  map<string, string> vars;
-  //  vars["index"] = SimpleItoa(i);
-  //  vars["method"] = UnderscoresToCamelCase(method);
-  //  vars["input"] = ClassName(method->input_type());
-  //  vars["output"] = ClassName(method->output_type());
-  //  printer->Print(vars,
-  //    "\n"
-  //    "public void $method$(\n"
-  //    "    com.google.protobuf.RpcController controller,\n"
-  //    "    $input$ request,\n"
-  //    "    com.google.protobuf.RpcCallback<$output$> done) {\n"
-  //    "  channel.callMethod(\n"
-  //    "    getDescriptor().getMethods().get($index$),\n"
-  //    "    controller,\n"
-  //    "    request,\n"
-  //    "    $output$.getDefaultInstance(),\n"
-  //    "    com.google.protobuf.RpcUtil.generalizeCallback(\n"
-  //    "      done,\n"
-  //    "      $output$.class,\n"
-  //    "      $output$.getDefaultInstance()));\n"
-  //    "}\n");
-  //}
-
-  //printer->Outdent();
-  //printer->Print("}\n");
+void ServiceGenerator::GenerateStubMethods(io::Printer* printer) {
+  for (int i = 0; i < descriptor_->method_count(); i++) {
+    const MethodDescriptor* method = descriptor_->method(i);
+    map<string, string> vars;
+    vars["method"] = UnderscoresToCamelCase(method);
+    vars["full_name"] = method->full_name();
+    vars["input"] = QualifiedMessageClassName(method->input_type());
+    vars["output"] = QualifiedMessageClassName(method->output_type());
+    vars["channel"] = CacheTtlMs(method) > 0 ? "cache" : "channel";
+    printer->Print(vars,
+      "\n"
+      "/** done is a function(response:$output$, error:Error). */\n"
+      "public function $method$(request:$input$, done:Function):void {\n"
+      "  $channel$.callMethod(\"$full_name$\", request, $output$, done);\n"
+      "}\n");
+  }
 }
 
 }  // namespace as3
@@ -23,6 +23,7 @@
 
 #include <map>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/compiler/as3/as3_options.h>
 
 namespace google {
 namespace protobuf {
@@ -37,23 +38,19 @@ namespace as3 {
 
 class ServiceGenerator {
  public:
-  explicit ServiceGenerator(const ServiceDescriptor* descriptor);
+  ServiceGenerator(const ServiceDescriptor* descriptor,
+                   const GeneratorOptions& options);
   ~ServiceGenerator();
 
   void Generate(io::Printer* printer);
 
  private:
-  // Generate the implementation of Service.callMethod().
-  void GenerateCallMethod(io::Printer* printer);
-
-  // Generate the implementations of Service.get{Request,Response}Prototype().
-  enum RequestOrResponse { REQUEST, RESPONSE };
-  void GenerateGetPrototype(RequestOrResponse which, io::Printer* printer);
-
-  // Generate a stub implementation of the service.
-  void GenerateStub(io::Printer* printer);
+  // Generate the client method of each rpc, which sends its request
+  // through the RpcChannel.
+  void GenerateStubMethods(io::Printer* printer);
 
   const ServiceDescriptor* descriptor_;
+  const GeneratorOptions& options_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ServiceGenerator);
 };
@@ -0,0 +1,92 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+
+#include <google/protobuf/compiler/as3/as3_template.h>
+#include <google/protobuf/io/printer.h>
+
+namespace google {
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+Template::Template(const char* text, const char* const slot_names[],
+                   int slot_count) {
+  Segment segment;
+  segment.slot = kLiteral;
+  for (const char* p = text; *p != '\0'; p++) {
+    if (*p == '\n') {
+      if (!segment.text.empty()) segments_.push_back(segment);
+      segment.text.clear();
+      segment.slot = kEndOfLine;
+      segments_.push_back(segment);
+      segment.slot = kLiteral;
+    } else if (*p == '$') {
+      const char* end = strchr(p + 1, '$');
+      GOOGLE_CHECK(end != NULL) << " Unclosed slot name in: " << text;
+      string name(p + 1, end - p - 1);
+      p = end;
+      if (name.empty()) {
+        // Two delimiters in a row reduce to a literal '$'.
+        segment.text += '$';
+        continue;
+      }
+      int slot = 0;
+      while (slot < slot_count && name != slot_names[slot]) slot++;
+      GOOGLE_CHECK_LT(slot, slot_count) << " Undefined slot: " << name;
+
+      if (!segment.text.empty()) segments_.push_back(segment);
+      segment.text.clear();
+      segment.slot = slot;
+      segments_.push_back(segment);
+      segment.slot = kLiteral;
+    } else {
+      segment.text += *p;
+    }
+  }
+  if (!segment.text.empty()) segments_.push_back(segment);
+}
+
+Template::~Template() {}
+
+void Template::Render(const string values[], io::Printer* printer) const {
+  string line;
+  for (size_t i = 0; i < segments_.size(); i++) {
+    const Segment& segment = segments_[i];
+    switch (segment.slot) {
+      case kLiteral:
+        line += segment.text;
+        break;
+      case kEndOfLine:
+        // Print() handles the newline, so the next line gets indented; an
+        // empty line is only the newline, as if the template was printed.
+        printer->PrintRaw(line);
+        printer->Print("\n");
+        line.clear();
+        break;
+      default:
+        line += values[segment.slot];
+        break;
+    }
+  }
+  printer->PrintRaw(line);
+}
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+}  // namespace google
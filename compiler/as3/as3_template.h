@@ -0,0 +1,71 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.
+// http://code.google.com/p/protobuf/
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Templates of generated code, parsed once into literal text and numbered
+// slots, then rendered any number of times from an array of values.
+// io::Printer::Print() scans its text for "$name$" and looks every name up
+// in a map<string, string> at each call, which adds up for the code printed
+// once per field, see as3_field_templates.h.
+
+#ifndef GOOGLE_PROTOBUF_COMPILER_AS3_TEMPLATE_H__
+#define GOOGLE_PROTOBUF_COMPILER_AS3_TEMPLATE_H__
+
+#include <string>
+#include <vector>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+  namespace io {
+    class Printer;             // printer.h
+  }
+}
+
+namespace protobuf {
+namespace compiler {
+namespace as3 {
+
+class Template {
+ public:
+  // Parses text, in which "$name$" is the slot numbered by the index of name
+  // in slot_names[0..slot_count), and "$$" a literal '$'.  Like the variables
+  // of io::Printer, names which are not slots are fatal.
+  Template(const char* text, const char* const slot_names[], int slot_count);
+  ~Template();
+
+  // Prints the template with values[i] in slot i.  Each line is built in a
+  // buffer first, then printed, so it is indented like the code around it.
+  void Render(const string values[], io::Printer* printer) const;
+
+ private:
+  // Literal text, which never spans lines, the end of a line, or a slot.
+  enum { kLiteral = -2, kEndOfLine = -1 };
+  struct Segment {
+    int slot;
+    string text;
+  };
+
+  vector<Segment> segments_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Template);
+};
+
+}  // namespace as3
+}  // namespace compiler
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_COMPILER_AS3_TEMPLATE_H__